@@ -23,7 +23,10 @@ public class FlexSpline : ModuleRules
 		
 		PrivateDependencyModuleNames.AddRange(new[] {
 			"CoreUObject",
-			"Engine"
+			"Engine",
+			"MeshDescription",
+			"StaticMeshDescription",
+			"ProceduralMeshComponent"
 		});
 
 
@@ -1,9 +1,41 @@
 #include "FlexSplineActor.h"
 #include "Components/SplineComponent.h"
 #include "Components/SplineMeshComponent.h"
-#include "Components/ArrowComponent.h"
-#include "Components/TextRenderComponent.h"
-#include "Kismet/KismetMathLibrary.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "ProceduralMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "FlexSplineModule.h"
+#include "FlexSplineDebugComponent.h"
+#include "FlexSplineMeshDeformer.h"
+#include "FlexSplineMeshBaker.h"
+#include "FlexSplinePointDiff.h"
+#include "FlexSplineRandom.h"
+#include "FlexSplineSolveKernels.h"
+#include "HAL/IConsoleManager.h"
+#include "Algo/BinarySearch.h"
+#include "Misc/MemStack.h"
+#include "Misc/ScopedSlowTask.h"
+
+static TAutoConsoleVariable<int32> CVarFlexSplineForceFullRebuild(
+	TEXT("FlexSpline.ForceFullRebuild"),
+	0,
+	TEXT("If set, Flex Splines rebuild all meshes on every construction instead of only the ones whose points have changed.\n")
+	TEXT("Useful to compare the incremental construction against a full rebuild."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarFlexSplineGenericSolve(
+	TEXT("FlexSpline.GenericSolve"),
+	0,
+	TEXT("If set, Flex Splines solve each point through the generic path instead of the kernel specialized for its layer's settings.\n")
+	TEXT("Useful to compare both with stat FlexSpline, results are the same up to float precision."),
+	ECVF_Default);
+
+DECLARE_CYCLE_STAT(TEXT("Construct Spline Mesh"), STAT_FlexSplineConstruct, STATGROUP_FlexSpline);
+DECLARE_CYCLE_STAT(TEXT("Solve Mesh Components"), STAT_FlexSplineSolve, STATGROUP_FlexSpline);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Updated Components (last construction)"), STAT_FlexSplineUpdatedComponents, STATGROUP_FlexSpline);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Skipped Components (last construction)"), STAT_FlexSplineSkippedComponents, STATGROUP_FlexSpline);
 
 // Helper aliases, for terser code
 static const auto StaticMeshClass = UStaticMeshComponent::StaticClass();
@@ -11,8 +43,37 @@ static const auto SplineMeshClass = USplineMeshComponent::StaticClass();
 static const auto LocalSpace = ESplineCoordinateSpace::Local;
 static const auto WorldSpace = ESplineCoordinateSpace::World;
 
+// Number of consecutive spline points that share one dynamic mesh section
+static constexpr int32 DynamicMeshChunkSize = 32;
+
+// Below this number of (layer, point) pairs the solve phase runs on the game thread only.
+// Dispatching to worker threads allocates task data, a construction without changes solves no point and never does
+static constexpr int32 ParallelSolveMinItems = 64;
+
+// Number of consecutive points of one layer solved by one work item
+static constexpr int32 SolveBatchSize = FFlexLayerKernel::MaxBatchSize;
+
+// Number of steps a rotation minimizing frame is carried along per spline segment, more steps follow tight turns closer
+static constexpr int32 SplineFrameSubsteps = 4;
+
+// Smallest distance between meshes of a layer placed by distance
+static constexpr float MinPlacementSpacing = 1.f;
+
+// Upper limit of segments merged into one spline mesh
+static constexpr int32 MaxCoalescedSegments = 16;
+
+// Largest gap between merged segments and deviation of their offsets, in cm
+static constexpr float CoalesceLocationTolerance = 0.1f;
+
+// Bump whenever the solve or the input hash changes, so construction caches saved with older versions are not used anymore
+static constexpr uint32 ConstructionCacheVersion = 2;
+
 //////////////////////////////////////////////////////////////////////////
 // STATIC HELPERS
+#if WITH_EDITORONLY_DATA
+// Length of a debug up direction arrow of size one
+static constexpr float DebugArrowLength = 80.f;
+
 static FColor GetColorForArrow(int32 MeshIndex)
 {
 	static const TArray<FColor> Colors = {
@@ -32,27 +93,7 @@ static FColor GetColorForArrow(int32 MeshIndex)
 	MeshIndex = FMath::Clamp(MeshIndex, 0, Colors.Num() - 1);
 	return Colors[MeshIndex];
 }
-
-static float RandomizeFloat(float InFloat, int32 Index, FName LayerName)
-{
-	const int32 Seed  = GetTypeHash(LayerName) + static_cast<int32>(InFloat) + Index;
-	return InFloat * UKismetMathLibrary::RandomFloatInRangeFromStream(-1.f, 1.f, FRandomStream(Seed));
-}
-
-static FVector RandomizeVector(const FVector& InVec, int32 Index, FName LayerName)
-{
-	const float RandX = InVec.X != 0.f ? RandomizeFloat(InVec.X, Index, LayerName) : 0.f;
-	const float RandY = InVec.Y != 0.f ? RandomizeFloat(InVec.Y, Index, LayerName) : 0.f;
-	const float RandZ = InVec.Z != 0.f ? RandomizeFloat(InVec.Z, Index, LayerName) : 0.f;
-
-	return {RandX, RandY, RandZ};
-}
-
-static FRotator RandomizeRotator(const FRotator& InRot, int32 Index, FName LayerName)
-{
-	const FVector VecFromRot = RandomizeVector(InRot.Euler(), Index, LayerName);
-	return {VecFromRot.X, VecFromRot.Y, VecFromRot.Z};
-}
+#endif
 
 static uint32 GeneratePointHashValue(const USplineComponent* const SplineComp, int32 Index)
 {
@@ -61,14 +102,52 @@ static uint32 GeneratePointHashValue(const USplineComponent* const SplineComp, i
 		 : 0;
 }
 
-static float FSeededRand(int32 Seed)
+static uint32 GeneratePointInputHash(const USplineComponent* const SplineComp, const FSplinePointData& PointData, int32 Index)
 {
-	return UKismetMathLibrary::RandomFloatInRangeFromStream(0.f, 1.f, FRandomStream((Seed + 1) * 13));
+	// Spline point key, tangents are stored with the point so auto tangent changes of neighbours are caught as well.
+	// The key is hashed relative to the index, so points behind an inserted or deleted point keep their hash
+	const FInterpCurvePoint<FVector>& Position = SplineComp->SplineCurves.Position.Points[Index];
+	const float KeyOffset = Position.InVal - static_cast<float>(Index);
+	uint32 Hash = FCrc::MemCrc32(&KeyOffset, sizeof(float));
+	Hash = FCrc::MemCrc32(&Position.OutVal, sizeof(FVector), Hash);
+	Hash = FCrc::MemCrc32(&Position.ArriveTangent, sizeof(FVector), Hash);
+	Hash = FCrc::MemCrc32(&Position.LeaveTangent, sizeof(FVector), Hash);
+	Hash = HashCombine(Hash, static_cast<uint32>(Position.InterpMode.GetValue()));
+
+	if (SplineComp->SplineCurves.Rotation.Points.IsValidIndex(Index))
+	{
+		Hash = FCrc::MemCrc32(&SplineComp->SplineCurves.Rotation.Points[Index].OutVal, sizeof(FQuat), Hash);
+	}
+	if (SplineComp->SplineCurves.Scale.Points.IsValidIndex(Index))
+	{
+		Hash = FCrc::MemCrc32(&SplineComp->SplineCurves.Scale.Points[Index].OutVal, sizeof(FVector), Hash);
+	}
+
+	// Point data
+	Hash = FCrc::MemCrc32(&PointData.StartRoll, sizeof(float), Hash);
+	Hash = FCrc::MemCrc32(&PointData.EndRoll, sizeof(float), Hash);
+	Hash = FCrc::MemCrc32(&PointData.StartScale, sizeof(FVector2D), Hash);
+	Hash = FCrc::MemCrc32(&PointData.EndScale, sizeof(FVector2D), Hash);
+	Hash = FCrc::MemCrc32(&PointData.StartOffset, sizeof(FVector2D), Hash);
+	Hash = FCrc::MemCrc32(&PointData.EndOffset, sizeof(FVector2D), Hash);
+	Hash = FCrc::MemCrc32(&PointData.CustomPointUpDirection, sizeof(FVector), Hash);
+	Hash = HashCombine(Hash, static_cast<uint32>(PointData.bSynchroniseWithPrevious));
+	Hash = FCrc::MemCrc32(&PointData.SMLocationOffset, sizeof(FVector), Hash);
+	Hash = FCrc::MemCrc32(&PointData.SMScale, sizeof(FVector), Hash);
+	Hash = FCrc::MemCrc32(&PointData.SMRotation, sizeof(FRotator), Hash);
+
+	return Hash;
 }
 
-static UClass* GetMeshType(EFlexSplineMeshType MeshType)
+static UClass* GetMeshType(const FSplineMeshInitData& MeshInitData)
 {
-	switch (MeshType)
+	// Instanced, dynamic and baked layers do not use a component per spline point
+	if (MeshInitData.MeshInfo.IsInstanced() || MeshInitData.MeshInfo.IsDynamic() || MeshInitData.IsBaked())
+	{
+		return nullptr;
+	}
+
+	switch (MeshInitData.MeshInfo.MeshType)
 	{
 		case EFlexSplineMeshType::SplineMesh: return SplineMeshClass;
 		case EFlexSplineMeshType::StaticMesh: return StaticMeshClass;
@@ -76,14 +155,14 @@ static UClass* GetMeshType(EFlexSplineMeshType MeshType)
 	}
 }
 
-static bool CanRenderFromSpawnChance(const FSplineMeshInitData& MeshInitData, int32 CurrentIndex)
+static bool CanRenderFromSpawnChance(const FSplineMeshInitData& MeshInitData, int32 CurrentIndex, float SpawnRoll)
 {
 	const float SpawnChance = MeshInitData.RenderInfo.SpawnChance;
-	const int32 SpawnSeed   = GetTypeHash(MeshInitData.MeshComponentsArray[CurrentIndex]->GetName()) * SpawnChance;
 
+	// The roll is seeded by the point's identity and does not depend on the spawn chance, so raising it only ever adds meshes
 	if (MeshInitData.RenderInfo.bRandomizeSpawnChance)
 	{
-		return SpawnChance > FSeededRand(SpawnSeed);
+		return SpawnChance > SpawnRoll;
 	}
 
 	// Compare index-spawn-chance-ratio and see if it has changed from ratio of last index
@@ -96,54 +175,584 @@ static bool CanRenderFromSpawnChance(const FSplineMeshInitData& MeshInitData, in
 	return CurrentRatio != LastRatio;
 }
 
+static bool DependsOnPointIndex(const FSplineMeshInitData& MeshInitData)
+{
+	// Linear spawn chance and custom render indices count points, so inserting a point changes every point after it
+	const bool bLinearSpawnChance = !MeshInitData.RenderInfo.bRandomizeSpawnChance && MeshInitData.RenderInfo.SpawnChance < 1.f;
+	return bLinearSpawnChance || TEST_BIT(MeshInitData.RenderInfo.RenderMode, EFlexSplineRenderMode::Custom);
+}
+
+static bool UsesSplineFrames(const FSplineMeshInitData& MeshInitData)
+{
+	return MeshInitData.LocationInfo.CoordinateSystem == EFlexCoordinateSystem::SplineFrame
+		|| MeshInitData.RotationInfo.CoordinateSystem == EFlexCoordinateSystem::SplineFrame
+		|| MeshInitData.UpVectorInfo.CoordinateSystem == EFlexCoordinateSystem::SplineFrame;
+}
+
+/**
+* Carry @param Frame from @param StartLocation to @param EndLocation, where the spline points along @param EndDirection.
+* Double reflection method (Wang et al. 2008): mirror the frame at the plane between both locations, then at the plane
+* between the mirrored and the actual direction. The frame turns with the spline, but never twists around it
+*/
+static FQuat TransportFrame(const FQuat& Frame, const FVector& StartLocation, const FVector& EndLocation, const FVector& EndDirection)
+{
+	if (EndDirection.IsNearlyZero())
+	{
+		return Frame;
+	}
+
+	const FVector StartDirection = Frame.GetForwardVector();
+	const FVector Chord = EndLocation - StartLocation;
+	const float ChordSquared = Chord.SizeSquared();
+	if (ChordSquared < KINDA_SMALL_NUMBER)
+	{
+		return FQuat::FindBetweenNormals(StartDirection, EndDirection) * Frame;
+	}
+
+	const FVector StartRight = Frame.GetRightVector();
+	const FVector ReflectedDirection = StartDirection - Chord * (2.f * (Chord | StartDirection) / ChordSquared);
+	const FVector ReflectedRight = StartRight - Chord * (2.f * (Chord | StartRight) / ChordSquared);
+	const FVector Correction = EndDirection - ReflectedDirection;
+	const float CorrectionSquared = Correction.SizeSquared();
+	const FVector EndRight = CorrectionSquared < SMALL_NUMBER
+		? ReflectedRight
+		: ReflectedRight - Correction * (2.f * (Correction | ReflectedRight) / CorrectionSquared);
+
+	return FRotationMatrix::MakeFromXY(EndDirection, EndRight).ToQuat();
+}
+
+static FQuat GetFrameAtInputKey(const FFlexSplineSamples& Samples, float InputKey)
+{
+	// Frames are only carried from point to point, in between they turn evenly
+	const int32 NumFrames = Samples.Frames.Num();
+	const int32 Index = FMath::Clamp(FMath::FloorToInt(InputKey), 0, NumFrames - 1);
+	return FQuat::Slerp(Samples.Frames[Index], Samples.Frames[(Index + 1) % NumFrames], InputKey - Index);
+}
+
+/** @param bPointsChanged is true if any point is dirty, has been shifted or has a changed frame */
+static bool NeedsAllPointsSolved(const FSplineMeshInitData& MeshInitData, int32 NumSplinePoints, bool bPointsChanged)
+{
+	// Merged segments span several points, so merging needs the segments around every changed point.
+	// Without changed points the merged components stay as they are
+	if (MeshInitData.MeshInfo.IsCoalesced())
+	{
+		return bPointsChanged;
+	}
+
+	// Layers that keep per point state from the last construction need all points again once that state is gone
+	if (MeshInitData.MeshInfo.IsInstanced())
+	{
+		return !MeshInitData.InstancedMeshComponent.IsValid() || MeshInitData.InstanceIndices.Num() != NumSplinePoints;
+	}
+	if (MeshInitData.MeshInfo.IsDynamic())
+	{
+		return MeshInitData.DynamicMesh.SegmentParams.Num() != NumSplinePoints;
+	}
+	return false;
+}
+
+/**
+* Hash of an asset. Only the path is stable between sessions, pointers and name table indices are not.
+* Building the path allocates, so hashes that are not saved use the pointer
+*/
+static uint32 GetAssetHash(const UObject* Asset, bool bStable)
+{
+	if (!bStable)
+	{
+		return GetTypeHash(Asset);
+	}
+	return Asset != nullptr ? FCrc::StrCrc32(*Asset->GetPathName()) : 0;
+}
+
+static uint32 GetPlacementHash(const FSplineMeshInitData& MeshInitData, bool bCanLoop)
+{
+	const FFlexRenderInfo& RenderInfo = MeshInitData.RenderInfo;
+	uint32 Hash = HashCombine(MeshInitData.LayerSeed, static_cast<uint32>(TEST_BIT(MeshInitData.GeneralInfo, EFlexGeneralFlags::Active)));
+	Hash = HashCombine(Hash, static_cast<uint32>(bCanLoop));
+	Hash = HashCombine(Hash, static_cast<uint32>(RenderInfo.bRandomizeSpawnChance));
+	Hash = HashCombine(Hash, GetTypeHash(RenderInfo.SpawnChance));
+	Hash = HashCombine(Hash, static_cast<uint32>(RenderInfo.RenderMode));
+
+	// Set iteration order is not defined, so custom indices are combined order independently
+	uint32 CustomIndicesHash = 0;
+	for (const uint32 CustomIndex : RenderInfo.RenderModeCustomIndices)
+	{
+		CustomIndicesHash += GetTypeHash(CustomIndex) * 0x9E3779B9u;
+	}
+	return HashCombine(Hash, CustomIndicesHash);
+}
+
+/**
+* Hash of everything the placement of a layer's meshes depends on: mesh, rendering, transform and up vector settings,
+* the layer's seed and the global loop and synchronize configs. Debug settings, material and collision are left out.
+* @param bStable hashes assets by path, for hashes that are saved
+*/
+static uint32 GetLayerConfigHash(const FSplineMeshInitData& MeshInitData, bool bCanLoop, EFlexGlobalConfigType SynchronizeConfig, bool bStable)
+{
+	uint32 Hash = GetPlacementHash(MeshInitData, bCanLoop);
+	Hash = HashCombine(Hash, static_cast<uint32>(SynchronizeConfig));
+
+	const FFlexMeshInfo& MeshInfo = MeshInitData.MeshInfo;
+	Hash = HashCombine(Hash, static_cast<uint32>(MeshInfo.MeshType));
+	Hash = HashCombine(Hash, static_cast<uint32>(MeshInfo.MeshForwardAxis));
+	Hash = HashCombine(Hash, GetAssetHash(MeshInfo.Mesh, bStable));
+	Hash = HashCombine(Hash, static_cast<uint32>(MeshInfo.bUseInstancing));
+	Hash = HashCombine(Hash, static_cast<uint32>(MeshInfo.bUseDynamicMesh));
+	Hash = HashCombine(Hash, static_cast<uint32>(MeshInfo.bSubdivideSegments));
+	Hash = HashCombine(Hash, static_cast<uint32>(MeshInfo.bCoalesceSegments));
+	Hash = HashCombine(Hash, GetTypeHash(MeshInfo.CoalesceAngleTolerance));
+	Hash = HashCombine(Hash, GetTypeHash(MeshInfo.CoalesceScaleTolerance));
+	Hash = HashCombine(Hash, static_cast<uint32>(MeshInfo.PlacementMode));
+	Hash = HashCombine(Hash, GetTypeHash(MeshInfo.PlacementSpacing));
+	for (const UStaticMesh* BakedMesh : MeshInitData.BakedMeshes)
+	{
+		Hash = HashCombine(Hash, GetAssetHash(BakedMesh, bStable));
+	}
+
+	const FFlexLocationInfo& LocationInfo = MeshInitData.LocationInfo;
+	Hash = HashCombine(Hash, static_cast<uint32>(LocationInfo.CoordinateSystem));
+	Hash = FCrc::MemCrc32(&LocationInfo.Location, sizeof(FVector), Hash);
+	Hash = FCrc::MemCrc32(&LocationInfo.LocationRandomOffset, sizeof(FVector), Hash);
+
+	const FFlexRotationInfo& RotationInfo = MeshInitData.RotationInfo;
+	Hash = HashCombine(Hash, static_cast<uint32>(RotationInfo.CoordinateSystem));
+	Hash = FCrc::MemCrc32(&RotationInfo.Rotation, sizeof(FRotator), Hash);
+	Hash = FCrc::MemCrc32(&RotationInfo.RotationRandomOffset, sizeof(FRotator), Hash);
+
+	const FFlexScaleInfo& ScaleInfo = MeshInitData.ScaleInfo;
+	Hash = HashCombine(Hash, static_cast<uint32>(ScaleInfo.bUseUniformScale));
+	Hash = FCrc::MemCrc32(&ScaleInfo.UniformScale, sizeof(float), Hash);
+	Hash = FCrc::MemCrc32(&ScaleInfo.Scale, sizeof(FVector), Hash);
+	Hash = HashCombine(Hash, static_cast<uint32>(ScaleInfo.bUseUniformScaleRandomOffset));
+	Hash = FCrc::MemCrc32(&ScaleInfo.UniformScaleRandomOffset, sizeof(float), Hash);
+	Hash = FCrc::MemCrc32(&ScaleInfo.ScaleRandomOffset, sizeof(FVector), Hash);
+
+	const FFlexUpVectorInfo& UpVectorInfo = MeshInitData.UpVectorInfo;
+	Hash = HashCombine(Hash, static_cast<uint32>(UpVectorInfo.CoordinateSystem));
+	Hash = FCrc::MemCrc32(&UpVectorInfo.CustomMeshUpDirection, sizeof(FVector), Hash);
+	return Hash;
+}
+
+/** Hash of the material and collision settings of a layer, @param Collision already takes the global collision config into account */
+static uint32 GetLayerSettingsHash(const FSplineMeshInitData& MeshInitData, ECollisionEnabled::Type Collision)
+{
+	uint32 Hash = GetTypeHash(MeshInitData.MeshInfo.MeshMaterial);
+	Hash = HashCombine(Hash, static_cast<uint32>(Collision));
+	Hash = HashCombine(Hash, GetTypeHash(MeshInitData.PhysicsInfo.CollisionProfileName));
+	return HashCombine(Hash, static_cast<uint32>(MeshInitData.PhysicsInfo.bGenerateOverlapEvent));
+}
+
+#if WITH_EDITOR
+/** Update stages required by a change inside a mesh layer, @param PropertyPath starts at the layer map */
+static uint8 ClassifyLayerProperty(const TArray<FName>& PropertyPath)
+{
+	// Changes of the map itself (adding, removing or renaming layers) are structural
+	uint8 Updates = 0;
+	SET_BIT(Updates, EFlexUpdateFlags::Structural);
+
+	for (const FName& Name : PropertyPath)
+	{
+		if (Name == GET_MEMBER_NAME_CHECKED(FSplineMeshInitData, MeshInfo))
+		{
+			if (PropertyPath.Contains(GET_MEMBER_NAME_CHECKED(FFlexMeshInfo, MeshMaterial)))
+			{
+				Updates = 0;
+				SET_BIT(Updates, EFlexUpdateFlags::Material);
+			}
+			else if (PropertyPath.Contains(GET_MEMBER_NAME_CHECKED(FFlexMeshInfo, MeshForwardAxis)))
+			{
+				Updates = 0;
+				SET_BIT(Updates, EFlexUpdateFlags::Transform);
+			}
+			break;
+		}
+		if (Name == GET_MEMBER_NAME_CHECKED(FSplineMeshInitData, PhysicsInfo))
+		{
+			Updates = 0;
+			SET_BIT(Updates, EFlexUpdateFlags::Collision);
+			break;
+		}
+		if (Name == GET_MEMBER_NAME_CHECKED(FSplineMeshInitData, GeneralInfo)
+			|| Name == GET_MEMBER_NAME_CHECKED(FSplineMeshInitData, RenderInfo))
+		{
+			Updates = 0;
+			SET_BIT(Updates, EFlexUpdateFlags::Visibility);
+			break;
+		}
+		if (Name == GET_MEMBER_NAME_CHECKED(FSplineMeshInitData, UpVectorInfo)
+			&& PropertyPath.Contains(GET_MEMBER_NAME_CHECKED(FFlexUpVectorInfo, bShowUpDirection)))
+		{
+			Updates = 0;
+			SET_BIT(Updates, EFlexUpdateFlags::Debug);
+			break;
+		}
+		if (Name == GET_MEMBER_NAME_CHECKED(FSplineMeshInitData, LocationInfo)
+			|| Name == GET_MEMBER_NAME_CHECKED(FSplineMeshInitData, RotationInfo)
+			|| Name == GET_MEMBER_NAME_CHECKED(FSplineMeshInitData, ScaleInfo)
+			|| Name == GET_MEMBER_NAME_CHECKED(FSplineMeshInitData, UpVectorInfo))
+		{
+			Updates = 0;
+			SET_BIT(Updates, EFlexUpdateFlags::Transform);
+			break;
+		}
+	}
+
+	// Text renderers sit on top of the meshes and arrows follow spline meshes, so both move with them
+	if (TEST_BIT(Updates, EFlexUpdateFlags::Transform) || TEST_BIT(Updates, EFlexUpdateFlags::Visibility))
+	{
+		SET_BIT(Updates, EFlexUpdateFlags::Debug);
+	}
+	return Updates;
+}
+#endif
+
+/** Can the segments from @param First to @param Last be rendered as one spline mesh, from the start of the first to the end of the last? */
+static bool CanCoalesce(TArrayView<const FFlexMeshSolveResult> Results, int32 First, int32 Last, float AngleTolerance, float ScaleTolerance)
+{
+	const FFlexSplineMeshParams& FirstParams = Results[First].SplineParams;
+	const FFlexSplineMeshParams& LastParams = Results[Last].SplineParams;
+	const FVector SpanChord = LastParams.EndLocation - FirstParams.StartLocation;
+	const float SpanLength = SpanChord.Size();
+	if (SpanLength < KINDA_SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	const FVector SpanDirection = SpanChord / SpanLength;
+	const float MinCos = FMath::Cos(FMath::DegreesToRadians(AngleTolerance));
+	const float RollTolerance = FMath::DegreesToRadians(AngleTolerance);
+	const FVector FirstUpDirection = FirstParams.UpDirection.GetSafeNormal();
+
+	for (int32 Index = First; Index <= Last; Index++)
+	{
+		const FFlexMeshSolveResult& Result = Results[Index];
+		const FFlexSplineMeshParams& Params = Result.SplineParams;
+
+		// Everything besides the segment itself is shared by the merged mesh
+		if (!Result.bVisible
+			|| Result.Collision != Results[First].Collision
+			|| Params.ForwardAxis != FirstParams.ForwardAxis
+			|| Params.RelativeLocation != FirstParams.RelativeLocation
+			|| Params.RelativeRotation != FirstParams.RelativeRotation
+			|| Params.RelativeScaleX != FirstParams.RelativeScaleX
+			|| (Params.UpDirection.GetSafeNormal() | FirstUpDirection) < MinCos)
+		{
+			return false;
+		}
+
+		// Straight: the segment and its tangents point along the span
+		if (((Params.EndLocation - Params.StartLocation).GetSafeNormal() | SpanDirection) < MinCos
+			|| (Params.StartTangent.GetSafeNormal() | SpanDirection) < MinCos
+			|| (Params.EndTangent.GetSafeNormal() | SpanDirection) < MinCos)
+		{
+			return false;
+		}
+
+		if (Index == First)
+		{
+			continue;
+		}
+
+		// Continuous: the segment starts where the previous one ends
+		const FFlexSplineMeshParams& PreviousParams = Results[Index - 1].SplineParams;
+		if (!Params.StartLocation.Equals(PreviousParams.EndLocation, CoalesceLocationTolerance)
+			|| !Params.StartOffset.Equals(PreviousParams.EndOffset, CoalesceLocationTolerance)
+			|| !Params.StartScale.Equals(PreviousParams.EndScale, ScaleTolerance)
+			|| FMath::Abs(Params.StartRoll - PreviousParams.EndRoll) > RollTolerance)
+		{
+			return false;
+		}
+
+		// Linear: roll, scale and offset at the joint are close to their interpolation across the span
+		const float Alpha = ((Params.StartLocation - FirstParams.StartLocation) | SpanDirection) / SpanLength;
+		if (!Params.StartOffset.Equals(FMath::Lerp(FirstParams.StartOffset, LastParams.EndOffset, Alpha), CoalesceLocationTolerance)
+			|| !Params.StartScale.Equals(FMath::Lerp(FirstParams.StartScale, LastParams.EndScale, Alpha), ScaleTolerance)
+			|| FMath::Abs(Params.StartRoll - FMath::Lerp(FirstParams.StartRoll, LastParams.EndRoll, Alpha)) > RollTolerance)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/** Stretch the segment at @param First to the end of the segment at @param Last and hide all segments in between */
+static void CoalesceSpan(TArrayView<FFlexMeshSolveResult> Results, int32 First, int32 Last)
+{
+	FFlexSplineMeshParams& Params = Results[First].SplineParams;
+	const FFlexSplineMeshParams& LastParams = Results[Last].SplineParams;
+
+	// Tangents keep their direction, their length grows with the span like that of a single segment would
+	const float SpanLength = FVector::Dist(Params.StartLocation, LastParams.EndLocation);
+	const float FirstLength = FVector::Dist(Params.StartLocation, Params.EndLocation);
+	const float LastLength = FVector::Dist(LastParams.StartLocation, LastParams.EndLocation);
+	Params.StartTangent *= FirstLength > KINDA_SMALL_NUMBER ? SpanLength / FirstLength : 1.f;
+	Params.EndTangent = LastParams.EndTangent * (LastLength > KINDA_SMALL_NUMBER ? SpanLength / LastLength : 1.f);
+	Params.EndLocation = LastParams.EndLocation;
+	Params.EndScale = LastParams.EndScale;
+	Params.EndOffset = LastParams.EndOffset;
+	Params.EndRoll = LastParams.EndRoll;
+
+	for (int32 Index = First + 1; Index <= Last; Index++)
+	{
+		Results[Index].bVisible = false;
+		Results[Index].Collision = ECollisionEnabled::NoCollision;
+	}
+}
+
+/** Do property changes since the last construction require all points of this layer to be placed again? */
+static bool HasPendingPlacementUpdate(const FSplineMeshInitData& MeshInitData)
+{
+	return TEST_BIT(MeshInitData.PendingUpdates, EFlexUpdateFlags::Transform)
+		|| TEST_BIT(MeshInitData.PendingUpdates, EFlexUpdateFlags::Visibility);
+}
+
 static ESplineMeshAxis::Type ToSplineAxis(EFlexSplineAxis FlexSplineAxis)
 {
 	return static_cast<ESplineMeshAxis::Type>( static_cast<uint8>(FlexSplineAxis) );
 }
 
-void DestroyMeshComponent(FSplineMeshInitData& MeshInitData, int32 Index)
+/** Hash of the type agnostic settings of a per point mesh component, never zero */
+static uint32 GetMeshSettingsHash(const FSplineMeshInitData& MeshInitData, ECollisionEnabled::Type Collision)
+{
+	uint32 Hash = GetTypeHash(MeshInitData.PhysicsInfo.CollisionProfileName);
+	Hash = HashCombine(Hash, static_cast<uint32>(Collision));
+	Hash = HashCombine(Hash, static_cast<uint32>(MeshInitData.PhysicsInfo.bGenerateOverlapEvent));
+	Hash = HashCombine(Hash, GetTypeHash(MeshInitData.MeshInfo.Mesh));
+	Hash = HashCombine(Hash, GetTypeHash(MeshInitData.MeshInfo.MeshMaterial));
+	return Hash != 0 ? Hash : 1;
+}
+
+/** Hash of all parameters pushed to a spline mesh component, never zero */
+static uint32 GetSplineMeshParamsHash(const FFlexSplineMeshParams& Params)
+{
+	uint32 Hash = FCrc::MemCrc32(&Params.StartLocation, sizeof(FVector));
+	Hash = FCrc::MemCrc32(&Params.StartTangent, sizeof(FVector), Hash);
+	Hash = FCrc::MemCrc32(&Params.EndLocation, sizeof(FVector), Hash);
+	Hash = FCrc::MemCrc32(&Params.EndTangent, sizeof(FVector), Hash);
+	Hash = FCrc::MemCrc32(&Params.StartScale, sizeof(FVector2D), Hash);
+	Hash = FCrc::MemCrc32(&Params.EndScale, sizeof(FVector2D), Hash);
+	Hash = FCrc::MemCrc32(&Params.StartOffset, sizeof(FVector2D), Hash);
+	Hash = FCrc::MemCrc32(&Params.EndOffset, sizeof(FVector2D), Hash);
+	Hash = FCrc::MemCrc32(&Params.StartRoll, sizeof(float), Hash);
+	Hash = FCrc::MemCrc32(&Params.EndRoll, sizeof(float), Hash);
+	Hash = FCrc::MemCrc32(&Params.UpDirection, sizeof(FVector), Hash);
+	Hash = HashCombine(Hash, static_cast<uint32>(Params.ForwardAxis));
+	Hash = FCrc::MemCrc32(&Params.RelativeLocation, sizeof(FVector), Hash);
+	Hash = FCrc::MemCrc32(&Params.RelativeRotation, sizeof(FRotator), Hash);
+	Hash = FCrc::MemCrc32(&Params.RelativeScaleX, sizeof(float), Hash);
+	return Hash != 0 ? Hash : 1;
+}
+
+/** Hash of the relative transform of a static mesh component, never zero */
+static uint32 GetTransformHash(const FTransform& Transform)
+{
+	// Hash components one by one, the transform itself may contain padding
+	const FVector Translation = Transform.GetTranslation();
+	const FQuat Rotation = Transform.GetRotation();
+	const FVector Scale = Transform.GetScale3D();
+	uint32 Hash = FCrc::MemCrc32(&Translation, sizeof(FVector));
+	Hash = FCrc::MemCrc32(&Rotation, sizeof(FQuat), Hash);
+	Hash = FCrc::MemCrc32(&Scale, sizeof(FVector), Hash);
+	return Hash != 0 ? Hash : 1;
+}
+
+/** Push type agnostic settings to a per point mesh component, unless they have been applied already. Returns true if anything was set */
+static bool ApplyMeshSettings(UStaticMeshComponent* MeshComp, const FSplineMeshInitData& MeshInitData, ECollisionEnabled::Type Collision,
+							  FFlexAppliedMeshState& AppliedState)
+{
+	const uint32 SettingsHash = GetMeshSettingsHash(MeshInitData, Collision);
+	if (SettingsHash == AppliedState.SettingsHash)
+	{
+		return false;
+	}
+
+	MeshComp->SetCollisionProfileName(MeshInitData.PhysicsInfo.CollisionProfileName);
+	MeshComp->SetCollisionEnabled(Collision);
+	MeshComp->SetGenerateOverlapEvents(MeshInitData.PhysicsInfo.bGenerateOverlapEvent);
+	MeshComp->SetMobility(EComponentMobility::Movable); // <- Required for SetStaticMesh to work correctly
+	MeshComp->SetStaticMesh(MeshInitData.MeshInfo.Mesh);
+	MeshComp->SetMobility(EComponentMobility::Static);
+	MeshComp->SetMaterial(0, MeshInitData.MeshInfo.MeshMaterial);
+	AppliedState.SettingsHash = SettingsHash;
+	return true;
+}
+
+void ReleaseMeshComponent(FFlexComponentPool& ComponentPool, FSplineMeshInitData& MeshInitData, int32 Index)
+{
+	ComponentPool.Release(MeshInitData.MeshComponentsArray[Index].Get());
+	MeshInitData.MeshComponentsArray[Index].Reset();
+	if (MeshInitData.AppliedMeshStates.IsValidIndex(Index))
+	{
+		MeshInitData.AppliedMeshStates[Index] = FFlexAppliedMeshState();
+	}
+}
+
+void ReleaseInstancedMeshComponent(FFlexComponentPool& ComponentPool, FSplineMeshInitData& MeshInitData)
+{
+	ComponentPool.Release(MeshInitData.InstancedMeshComponent.Get());
+	MeshInitData.InstancedMeshComponent.Reset();
+}
+
+void ReleaseBakedMeshComponents(FFlexComponentPool& ComponentPool, FSplineMeshInitData& MeshInitData)
+{
+	for (const FStaticMeshWeakPtr& Mesh : MeshInitData.BakedMeshComponentsArray)
+	{
+		ComponentPool.Release(Mesh.Get());
+	}
+	MeshInitData.BakedMeshComponentsArray.Empty();
+}
+
+void ReleaseDynamicMeshComponent(FFlexComponentPool& ComponentPool, FSplineMeshInitData& MeshInitData)
+{
+	ComponentPool.Release(MeshInitData.DynamicMesh.Component.Get());
+	MeshInitData.DynamicMesh = FFlexDynamicMeshState();
+}
+
+/** Add all components currently referenced by @param MeshInitData to @param OutComponents */
+void GatherLayerComponents(const FSplineMeshInitData& MeshInitData, TSet<UActorComponent*>& OutComponents)
 {
-	FStaticMeshWeakPtr Mesh = MeshInitData.MeshComponentsArray[Index];
-	if (Mesh.IsValid())
+	for (const FStaticMeshWeakPtr& Mesh : MeshInitData.MeshComponentsArray)
+	{
+		OutComponents.Add(Mesh.Get());
+	}
+	for (const FStaticMeshWeakPtr& Mesh : MeshInitData.BakedMeshComponentsArray)
 	{
-		Mesh->DestroyComponent();
+		OutComponents.Add(Mesh.Get());
 	}
-	MeshInitData.MeshComponentsArray.RemoveAt(Index);
+	OutComponents.Add(MeshInitData.InstancedMeshComponent.Get());
+	OutComponents.Add(MeshInitData.DynamicMesh.Component.Get());
 }
 
 
 //////////////////////////////////////////////////////////////////////////
 // STRUCT FUNCTIONS
-FSplineMeshInitData::~FSplineMeshInitData()
+UActorComponent* FFlexComponentPool::Rent(AActor* Owner, UClass* ComponentClass, USceneComponent* Parent)
+{
+	UActorComponent* Component = nullptr;
+	TArray<UActorComponent*>* Pooled = GetPooled(ComponentClass);
+	while (Pooled != nullptr && Pooled->Num() > 0 && Component == nullptr)
+	{
+		// Pooled components may have been destroyed together with their owner's other components
+		UActorComponent* Candidate = Pooled->Pop(false);
+		if (Candidate != nullptr && !Candidate->IsPendingKill())
+		{
+			Component = Candidate;
+		}
+	}
+	if (Component == nullptr)
+	{
+		Component = NewObject<UActorComponent>(Owner, ComponentClass);
+	}
+
+	Component->RegisterComponent();
+	if (USceneComponent* SceneComponent = Cast<USceneComponent>(Component))
+	{
+		SceneComponent->AttachToComponent(Parent, FAttachmentTransformRules::KeepRelativeTransform);
+	}
+	Rented.Add(Component);
+
+	return Component;
+}
+
+void FFlexComponentPool::Release(UActorComponent* Component)
 {
-	for (const FStaticMeshWeakPtr& Mesh : MeshComponentsArray)
+	if (Component == nullptr)
+	{
+		return;
+	}
+	Rented.Remove(Component);
+
+	TArray<UActorComponent*>* Pooled = GetPooled(Component->GetClass());
+	if (Pooled != nullptr && Pooled->Num() < MaxPooledPerClass && !Component->IsPendingKill())
 	{
-		if (Mesh.IsValid())
+		if (USceneComponent* SceneComponent = Cast<USceneComponent>(Component))
 		{
-			Mesh->ConditionalBeginDestroy();
+			SceneComponent->DetachFromComponent(FDetachmentTransformRules::KeepRelativeTransform);
+			SceneComponent->SetRelativeTransform(FTransform::Identity);
 		}
+		Component->UnregisterComponent();
+		Pooled->Add(Component);
 	}
-	for (const FArrowWeakPtr& Arrow : ArrowSplineUpIndicatorArray)
+	else
+	{
+		Component->DestroyComponent();
+	}
+}
+
+void FFlexComponentPool::ReleaseUnused(const TSet<UActorComponent*>& InUse)
+{
+	TArray<UActorComponent*> Unused;
+	for (UActorComponent* Component : Rented)
 	{
-		if (Arrow.IsValid())
+		if (!InUse.Contains(Component))
 		{
-			Arrow->ConditionalBeginDestroy();
+			Unused.Add(Component);
 		}
 	}
+	for (UActorComponent* Component : Unused)
+	{
+		Release(Component);
+	}
+}
+
+TArray<UActorComponent*>* FFlexComponentPool::GetPooled(UClass* ComponentClass)
+{
+	// Only plain mesh components are reused, all of their state is set when they are rented
+	if (ComponentClass == StaticMeshClass)
+	{
+		return &PooledStaticMeshes;
+	}
+	if (ComponentClass == SplineMeshClass)
+	{
+		return &PooledSplineMeshes;
+	}
+	return nullptr;
 }
 
 
+float FFlexArcLengthTable::GetInputKeyAtDistance(float Distance) const
+{
+	const int32 NumTableSegments = NumSegments();
+	if (NumTableSegments == 0)
+	{
+		return 0.f;
+	}
+
+	// Find the segment containing the distance, then the two samples around it
+	const int32 Segment = FMath::Clamp(Algo::UpperBound(SegmentDistances, Distance) - 1, 0, NumTableSegments - 1);
+	const float SegmentLength = SegmentDistances[Segment + 1] - SegmentDistances[Segment];
+	const float SegmentDistance = FMath::Clamp(Distance - SegmentDistances[Segment], 0.f, SegmentLength);
+	const TArrayView<const float> Samples = MakeArrayView(SegmentSamples.GetData() + Segment * SamplesPerSegment, SamplesPerSegment);
+	const int32 Sample = FMath::Min(Algo::LowerBound(Samples, SegmentDistance), SamplesPerSegment - 1);
+
+	const float SampleStart = Sample > 0 ? Samples[Sample - 1] : 0.f;
+	const float SampleLength = Samples[Sample] - SampleStart;
+	const float Alpha = SampleLength > KINDA_SMALL_NUMBER ? (SegmentDistance - SampleStart) / SampleLength : 0.f;
+	return Segment + (Sample + Alpha) / SamplesPerSegment;
+}
+
 //////////////////////////////////////////////////////////////////////////
 // CONSTRUCTOR + BASE INTERFACE + GETTER
 AFlexSplineActor::AFlexSplineActor():
 	CollisionActiveConfig(EFlexGlobalConfigType::Nowhere),
 	SynchronizeConfig(EFlexGlobalConfigType::Custom),
 	LoopConfig(EFlexGlobalConfigType::Custom),
+	RandomSeed(0),
 	bShowPointNumbers(false),
 	PointNumberSize(125.f),
 	UpDirectionArrowSize(3.f),
 	UpDirectionArrowOffset(25.f),
-	TextRenderColor(FColor::Cyan)
+	TextRenderColor(FColor::Cyan),
+	BakeCellSize(10000.f),
+	NextPointID(0),
+	FirstShiftedPointIndex(INDEX_NONE),
+	FirstChangedFrameIndex(INDEX_NONE),
+	bWasClosedLoop(false),
+	bFullRebuild(true),
+	bFullRebuildPending(true),
+	bDebugRefreshPending(false),
+	bPropertyChangeRouted(false),
+	LastConstructionTransform(FTransform::Identity)
 {
 	PrimaryActorTick.bCanEverTick = false;
 
@@ -151,14 +760,28 @@ AFlexSplineActor::AFlexSplineActor():
 	SplineComponent = CreateDefaultSubobject<USplineComponent>(TEXT("Spline"));
 	SplineComponent->SetMobility(EComponentMobility::Static);
 	RootComponent = SplineComponent;
+
+#if WITH_EDITORONLY_DATA
+	// Point numbers and up directions, not part of cooked builds
+	DebugComponent = CreateEditorOnlyDefaultSubobject<UFlexSplineDebugComponent>(TEXT("Debug"));
+#endif
 }
 
 void AFlexSplineActor::OnConstruction(const FTransform& Transform)
 {
 	Super::OnConstruction(Transform);
 
-	// FlexSpline construction for editor builds here
-	ConstructSplineMesh();
+	// FlexSpline construction for editor builds here. Generated components are placed relative to the spline,
+	// so moving the actor around only affects debug information placed in world space
+	if (IsTransformOnlyConstruction(Transform))
+	{
+		UpdateDebugTransforms();
+	}
+	else
+	{
+		ConstructSplineMesh();
+	}
+	LastConstructionTransform = Transform;
 }
 
 void AFlexSplineActor::PreInitializeComponents()
@@ -171,390 +794,1812 @@ void AFlexSplineActor::PreInitializeComponents()
 #endif
 }
 
-int32 AFlexSplineActor::GetMeshCountForType(EFlexSplineMeshType MeshType) const
+#if WITH_EDITOR
+void AFlexSplineActor::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
-	int32 Count = 0;
-	for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	// Without a property chain only the actor's member is known. Point data changes are detected per point,
+	// everything else may affect all meshes. Needs to be set before Super, which reruns the construction
+	if (!bPropertyChangeRouted)
 	{
-		const FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
-		if (MeshInitData.MeshInfo.MeshType == MeshType && TEST_BIT(MeshInitData.GeneralInfo, EFlexGeneralFlags::Active))
+		const FName MemberName = PropertyChangedEvent.MemberProperty != nullptr
+			? PropertyChangedEvent.MemberProperty->GetFName()
+			: PropertyChangedEvent.GetPropertyName();
+		RequestUpdate(ClassifyActorProperty(MemberName), INDEX_NONE);
+	}
+
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+}
+
+void AFlexSplineActor::PostEditChangeChainProperty(FPropertyChangedChainEvent& PropertyChangedEvent)
+{
+	// Route the change to the construction stages it affects, for the edited layer only if it is known
+	TArray<FName> PropertyPath;
+	for (auto* Node = PropertyChangedEvent.PropertyChain.GetActiveMemberNode(); Node != nullptr; Node = Node->GetNextNode())
+	{
+		PropertyPath.Add(Node->GetValue()->GetFName());
+	}
+
+	if (PropertyPath.Num() > 0)
+	{
+		const bool bLayerProperty = PropertyPath[0] == GET_MEMBER_NAME_CHECKED(AFlexSplineActor, MeshDataInitMap);
+		const uint8 Updates = bLayerProperty ? ClassifyLayerProperty(PropertyPath) : ClassifyActorProperty(PropertyPath[0]);
+		// Changes of the map itself, i.e. adding or removing layers, affect all layers
+		const int32 LayerIndex = bLayerProperty && PropertyPath.Num() > 1
+			? PropertyChangedEvent.GetArrayIndex(GET_MEMBER_NAME_STRING_CHECKED(AFlexSplineActor, MeshDataInitMap))
+			: INDEX_NONE;
+		RequestUpdate(Updates, LayerIndex);
+		bPropertyChangeRouted = true;
+	}
+
+	Super::PostEditChangeChainProperty(PropertyChangedEvent);
+	bPropertyChangeRouted = false;
+}
+
+uint8 AFlexSplineActor::ClassifyActorProperty(FName MemberName)
+{
+	uint8 Updates = 0;
+	if (MemberName == GET_MEMBER_NAME_CHECKED(AFlexSplineActor, PointDataArray)
+		|| MemberName == GET_MEMBER_NAME_CHECKED(AFlexSplineActor, MeshDataTemplate)
+		|| MemberName == GET_MEMBER_NAME_CHECKED(AFlexSplineActor, BakeCellSize))
+	{
+		// Point data is diffed per point, the others only affect future layers and bakes
+	}
+	else if (MemberName == GET_MEMBER_NAME_CHECKED(AFlexSplineActor, CollisionActiveConfig))
+	{
+		SET_BIT(Updates, EFlexUpdateFlags::Collision);
+	}
+	else if (MemberName == GET_MEMBER_NAME_CHECKED(AFlexSplineActor, RandomSeed)
+		|| MemberName == GET_MEMBER_NAME_CHECKED(AFlexSplineActor, LoopConfig)
+		|| MemberName == GET_MEMBER_NAME_CHECKED(AFlexSplineActor, SynchronizeConfig))
+	{
+		// Part of each layer's config hash, so only the layers that are actually affected are rebuilt
+		SET_BIT(Updates, EFlexUpdateFlags::Debug);
+	}
+	else if (MemberName == GET_MEMBER_NAME_CHECKED(AFlexSplineActor, bShowPointNumbers)
+		|| MemberName == GET_MEMBER_NAME_CHECKED(AFlexSplineActor, PointNumberSize)
+		|| MemberName == GET_MEMBER_NAME_CHECKED(AFlexSplineActor, UpDirectionArrowSize)
+		|| MemberName == GET_MEMBER_NAME_CHECKED(AFlexSplineActor, UpDirectionArrowOffset)
+		|| MemberName == GET_MEMBER_NAME_CHECKED(AFlexSplineActor, TextRenderColor))
+	{
+		SET_BIT(Updates, EFlexUpdateFlags::Debug);
+	}
+	else
+	{
+		SET_BIT(Updates, EFlexUpdateFlags::Structural);
+	}
+	return Updates;
+}
+
+void AFlexSplineActor::RequestUpdate(uint8 Updates, int32 LayerIndex)
+{
+	// The logical index of a map entry is its position when iterating the map
+	const bool bAllLayers = LayerIndex < 0 || LayerIndex >= MeshDataInitMap.Num();
+
+	// Structural changes inside of a known layer are picked up by its config hash, only that layer is rebuilt
+	if (TEST_BIT(Updates, EFlexUpdateFlags::Structural) && bAllLayers)
+	{
+		bFullRebuildPending = true;
+		return;
+	}
+	if (TEST_BIT(Updates, EFlexUpdateFlags::Debug) || TEST_BIT(Updates, EFlexUpdateFlags::Structural))
+	{
+		bDebugRefreshPending = true;
+	}
+
+	int32 CurrentLayerIndex = 0;
+	for (TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		if (bAllLayers || CurrentLayerIndex == LayerIndex)
 		{
-			Count++;
+			MeshInitDataPair.Value.PendingUpdates |= Updates;
 		}
+		CurrentLayerIndex++;
+	}
+}
+
+void AFlexSplineActor::PostEditUndo()
+{
+	// Undo may restore any property
+	bFullRebuildPending = true;
+
+	Super::PostEditUndo();
+}
+
+void AFlexSplineActor::PreSave(const ITargetPlatform* TargetPlatform)
+{
+	Super::PreSave(TargetPlatform);
+
+	// Saved and cooked actors bring their placement along, so loading them does not need to evaluate the spline
+	WriteConstructionCache();
+}
+#endif
+
+int32 AFlexSplineActor::GetMeshCountForType(EFlexSplineMeshType MeshType) const
+{
+	int32 Count = 0;
+	for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		const FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
+		if (MeshInitData.MeshInfo.MeshType == MeshType && TEST_BIT(MeshInitData.GeneralInfo, EFlexGeneralFlags::Active))
+		{
+			Count++;
+		}
+	}
+	return Count;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// FLEX SPLINE FUNCTIONALITY
+void AFlexSplineActor::ConstructSplineMesh()
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlexSplineConstruct);
+
+	// Temporaries of all stages live on the mem stack until the construction ends, results that outlive the
+	// construction are written to buffers kept by the actor. A rebuild without inserted or deleted points does not touch the heap
+	FMemMark MemMark(FMemStack::Get());
+
+	InitializeNewMeshData();
+
+	// Components of removed layers are only referenced by the pool, layers may be removed by any property change
+	if (bFullRebuildPending)
+	{
+		TSet<UActorComponent*> LayerComponents;
+		for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+		{
+			GatherLayerComponents(MeshInitDataPair.Value, LayerComponents);
+		}
+		ComponentPool.ReleaseUnused(LayerComponents);
+	}
+
+	// Find inserted, deleted and moved spline points
+	FFlexPointDiff PointDiff;
+	DiffSplinePoints(PointDiff);
+
+	// Bring point data and meshes in line with the spline points
+	ApplyPointDataDiff(PointDiff);
+	ApplyMeshDiff(PointDiff);
+
+	// Find out what needs to be re-evaluated
+	UpdateDirtyPoints();
+	UpdateLayerConfigs();
+	UpdateSplineSamples();
+	UpdateSplineFrames();
+	UpdateArcLengths();
+
+	// Update the spline itself with the gathered data. A valid construction cache replaces placing all meshes, e.g. on load
+	UpdatePointData();
+	if (!ReadConstructionCache(CurrentLayerSolves))
+	{
+		UpdatePlacementMasks();
+		SolveMeshComponents(CurrentLayerSolves, false);
+	}
+	CoalesceSegments(CurrentLayerSolves);
+	UpdateMeshComponents(CurrentLayerSolves);
+	UpdateDebugInformation();
+
+	bFullRebuildPending = false;
+	bDebugRefreshPending = false;
+	for (TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		MeshInitDataPair.Value.PendingUpdates = 0;
+	}
+}
+
+bool AFlexSplineActor::IsTransformOnlyConstruction(const FTransform& Transform) const
+{
+	// Without a pending update, a construction with a new actor transform stems from moving the actor
+	if (bFullRebuildPending
+		|| bDebugRefreshPending
+		|| CVarFlexSplineForceFullRebuild.GetValueOnGameThread() != 0
+		|| Transform.Equals(LastConstructionTransform, 0.f)
+		|| SplineComponent->GetNumberOfSplinePoints() != PointDataArray.Num())
+	{
+		return false;
+	}
+
+	for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		if (MeshInitDataPair.Value.PendingUpdates != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool AFlexSplineActor::IsDebugInformationShown() const
+{
+	if (bShowPointNumbers)
+	{
+		return true;
+	}
+	for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		if (MeshInitDataPair.Value.UpVectorInfo.bShowUpDirection)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void AFlexSplineActor::UpdateDebugTransforms()
+{
+	// Hidden debug information is refreshed once it is shown again
+	if (IsDebugInformationShown())
+	{
+		bDebugRefreshPending = true;
+		UpdateDebugInformation();
+		bDebugRefreshPending = false;
+	}
+}
+
+void AFlexSplineActor::InitializeNewMeshData()
+{
+	const int32 MeshInitMapNum = MeshDataInitMap.Num();
+
+	for (TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
+		if (!MeshInitData.IsInitialized())
+		{
+			// Generate name for new entry
+			for (int32 Index = 0; Index < MeshInitMapNum; Index++)
+			{
+				const FName NewLayerName = FName(*FString(TEXT("Layer " + FString::FromInt(Index))));
+				if ( !MeshDataInitMap.Contains(NewLayerName) && NewLayerName != LastUsedKey )
+				{
+					MeshInitDataPair.Key = NewLayerName;
+					LastUsedKey = NewLayerName;
+					break;
+				}
+			}
+
+			// Init data from template
+			MeshInitData = MeshDataTemplate;
+			MeshInitData.Initialize();
+			bFullRebuildPending = true;
+		}
+	}
+
+	// Cache layer identity, so evaluating a point never has to search the layer map
+	int32 LayerIndex = 0;
+	for (TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
+		MeshInitData.LayerName = MeshInitDataPair.Key;
+		MeshInitData.LayerIndex = LayerIndex++;
+		MeshInitData.LayerSeed = FFlexRandom::MakeLayerSeed(RandomSeed, MeshInitDataPair.Key);
+	}
+}
+
+void AFlexSplineActor::DiffSplinePoints(FFlexPointDiff& OutPointDiff) const
+{
+	const int32 NumSplinePoints = SplineComponent->GetNumberOfSplinePoints();
+
+	TArray<uint32, TMemStackAllocator<>> OldHashes;
+	OldHashes.SetNumUninitialized(PointDataArray.Num());
+	for (int32 Index = 0; Index < PointDataArray.Num(); Index++)
+	{
+		OldHashes[Index] = PointDataArray[Index].LocationHash;
+	}
+
+	TArray<uint32, TMemStackAllocator<>> NewHashes;
+	NewHashes.SetNumUninitialized(NumSplinePoints);
+	for (int32 Index = 0; Index < NumSplinePoints; Index++)
+	{
+		NewHashes[Index] = GeneratePointHashValue(SplineComponent, Index);
+	}
+
+	OutPointDiff.Compute(OldHashes, NewHashes);
+}
+
+void AFlexSplineActor::ApplyPointDataDiff(const FFlexPointDiff& PointDiff)
+{
+	const int32 NumSplinePoints = PointDiff.NewToOld.Num();
+
+	// Point data saved before points had an identity is identified by its index
+	for (int32 Index = 0; Index < PointDataArray.Num(); Index++)
+	{
+		FSplinePointData& PointData = PointDataArray[Index];
+		if (PointData.ID == INDEX_NONE)
+		{
+			PointData.ID = Index;
+		}
+		NextPointID = FMath::Max(NextPointID, PointData.ID + 1);
+	}
+
+	FirstShiftedPointIndex = PointDiff.FirstShiftedIndex;
+	if (!PointDiff.IsRemapped())
+	{
+		return;
+	}
+
+	// Compact point data and input hashes in a single pass, so unchanged points keep their data and stay clean
+	const bool bRemapInputHashes = PointInputHashes.Num() == PointDiff.NumOld;
+	TArray<FSplinePointData> NewPointDataArray;
+	TArray<uint32> NewPointInputHashes;
+	NewPointDataArray.SetNum(NumSplinePoints);
+	NewPointInputHashes.SetNumZeroed(bRemapInputHashes ? NumSplinePoints : 0);
+
+	for (int32 Index = 0; Index < NumSplinePoints; Index++)
+	{
+		const int32 OldIndex = PointDiff.NewToOld[Index];
+		if (OldIndex != INDEX_NONE)
+		{
+			NewPointDataArray[Index] = MoveTemp(PointDataArray[OldIndex]);
+			if (bRemapInputHashes)
+			{
+				NewPointInputHashes[Index] = PointInputHashes[OldIndex];
+			}
+		}
+		else
+		{
+			NewPointDataArray[Index].ID = NextPointID++;
+		}
+	}
+
+	PointDataArray = MoveTemp(NewPointDataArray);
+	PointInputHashes = MoveTemp(NewPointInputHashes);
+}
+
+void AFlexSplineActor::ApplyMeshDiff(const FFlexPointDiff& PointDiff)
+{
+	const int32 NumSplinePoints = PointDiff.NewToOld.Num();
+
+	// Each mesh-init data stores all mesh components of its type, one slot per spline point
+	for (TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
+		const bool bAligned = MeshInitData.MeshComponentsArray.Num() == PointDiff.NumOld;
+
+		if (bAligned && !PointDiff.IsRemapped())
+		{
+			// Unknown states only cause components to be updated once more
+			MeshInitData.AppliedMeshStates.SetNum(NumSplinePoints);
+			continue;
+		}
+
+		TArray<FStaticMeshWeakPtr> NewMeshComponents;
+		TArray<FFlexAppliedMeshState> NewAppliedMeshStates;
+		NewMeshComponents.SetNum(NumSplinePoints);
+		NewAppliedMeshStates.SetNum(NumSplinePoints);
+
+		if (bAligned)
+		{
+			for (const int32 OldIndex : PointDiff.Deleted)
+			{
+				ReleaseMeshComponent(ComponentPool, MeshInitData, OldIndex);
+			}
+
+			for (int32 Index = 0; Index < NumSplinePoints; Index++)
+			{
+				const int32 OldIndex = PointDiff.NewToOld[Index];
+				if (OldIndex != INDEX_NONE)
+				{
+					NewMeshComponents[Index] = MeshInitData.MeshComponentsArray[OldIndex];
+					if (MeshInitData.AppliedMeshStates.IsValidIndex(OldIndex))
+					{
+						NewAppliedMeshStates[Index] = MeshInitData.AppliedMeshStates[OldIndex];
+					}
+				}
+			}
+		}
+		else
+		{
+			// New layer, or layer out of sync with its points: start over
+			for (int32 Index = 0; Index < MeshInitData.MeshComponentsArray.Num(); Index++)
+			{
+				ReleaseMeshComponent(ComponentPool, MeshInitData, Index);
+			}
+		}
+
+		// Inserted points start without components, they are created once a point actually renders
+		MeshInitData.MeshComponentsArray = MoveTemp(NewMeshComponents);
+		MeshInitData.AppliedMeshStates = MoveTemp(NewAppliedMeshStates);
+
+		// Instance indices refer to old point indices
+		MeshInitData.InstanceIndices.Reset();
+	}
+}
+
+void AFlexSplineActor::UpdateDirtyPoints()
+{
+	const int32 NumSplinePoints = SplineComponent->GetNumberOfSplinePoints();
+	const bool bClosedLoop = SplineComponent->IsClosedLoop();
+
+	// Hashes of this construction are written to the scratch buffer and swapped in at the end, both keep their capacity
+	TArray<uint32>& NewPointInputHashes = ScratchPointInputHashes;
+	NewPointInputHashes.SetNumUninitialized(NumSplinePoints, false);
+	for (int32 Index = 0; Index < NumSplinePoints; Index++)
+	{
+		NewPointInputHashes[Index] = GeneratePointInputHash(SplineComponent, PointDataArray[Index], Index);
+	}
+
+	// Point input hashes have been remapped to the current points already. Shifted indices only matter
+	// to layers whose placement depends on the point index
+	bool bIndexDependentLayerShifted = false;
+	if (FirstShiftedPointIndex != INDEX_NONE)
+	{
+		for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+		{
+			bIndexDependentLayerShifted |= DependsOnPointIndex(MeshInitDataPair.Value);
+		}
+	}
+
+	bFullRebuild = bFullRebuildPending
+		|| CVarFlexSplineForceFullRebuild.GetValueOnGameThread() != 0
+		|| PointInputHashes.Num() != NumSplinePoints
+		|| bWasClosedLoop != bClosedLoop
+		|| bIndexDependentLayerShifted;
+
+	// Init would reallocate, bits of the last construction are overwritten instead
+	DirtyPoints.SetNum(NumSplinePoints, false);
+	DirtyPoints.SetRange(0, NumSplinePoints, bFullRebuild);
+
+	if (!bFullRebuild)
+	{
+		// A mesh depends on its own point, the previous point (synchronization, up direction) and the next point (segment end).
+		// So a changed point dirties its neighbours as well, wrapping around for loops
+		for (int32 Index = 0; Index < NumSplinePoints; Index++)
+		{
+			if (NewPointInputHashes[Index] != PointInputHashes[Index])
+			{
+				DirtyPoints[(Index + NumSplinePoints - 1) % NumSplinePoints] = true;
+				DirtyPoints[Index] = true;
+				DirtyPoints[(Index + 1) % NumSplinePoints] = true;
+			}
+		}
+
+		// Inserting or deleting points moves the end of the spline, which is never rendered without a loop.
+		// Without a loop the tail moves as well, which is the point before the end
+		if (FirstShiftedPointIndex != INDEX_NONE)
+		{
+			const int32 NumTailPoints = bClosedLoop ? 2 : 3;
+			for (int32 Index = FMath::Max(0, NumSplinePoints - NumTailPoints); Index < NumSplinePoints; Index++)
+			{
+				DirtyPoints[Index] = true;
+			}
+		}
+	}
+
+	Swap(PointInputHashes, ScratchPointInputHashes);
+	bWasClosedLoop = bClosedLoop;
+}
+
+void AFlexSplineActor::UpdateLayerConfigs()
+{
+	// Layers whose settings did not change are only re-evaluated at dirty points, no matter which layer has been edited
+	for (TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
+		const uint32 ConfigHash = GetLayerConfigHash(MeshInitData, GetCanLoop(MeshInitData), SynchronizeConfig, false);
+		const uint32 SettingsHash = GetLayerSettingsHash(MeshInitData, GetCollisionEnabled(MeshInitData));
+
+		if (ConfigHash != MeshInitData.ConfigHash)
+		{
+			SET_BIT(MeshInitData.PendingUpdates, EFlexUpdateFlags::Transform);
+			SET_BIT(MeshInitData.PendingUpdates, EFlexUpdateFlags::Visibility);
+			bDebugRefreshPending = true;
+		}
+		if (SettingsHash != MeshInitData.SettingsHash)
+		{
+			SET_BIT(MeshInitData.PendingUpdates, EFlexUpdateFlags::Material);
+			SET_BIT(MeshInitData.PendingUpdates, EFlexUpdateFlags::Collision);
+		}
+
+		MeshInitData.ConfigHash = ConfigHash;
+		MeshInitData.SettingsHash = SettingsHash;
+	}
+}
+
+void AFlexSplineActor::UpdateSplineSamples()
+{
+	const int32 NumSplinePoints = SplineComponent->GetNumberOfSplinePoints();
+
+	// A sample only depends on its own spline point, which is part of the point's input hash.
+	// Points before the first shifted index keep their samples
+	int32 FirstResampledIndex = FirstShiftedPointIndex != INDEX_NONE ? FirstShiftedPointIndex : NumSplinePoints;
+	if (bFullRebuild || (FirstShiftedPointIndex == INDEX_NONE && SplineSamples.Num() != NumSplinePoints))
+	{
+		FirstResampledIndex = 0;
+	}
+
+	SplineSamples.SetNum(NumSplinePoints);
+	for (int32 Index = 0; Index < NumSplinePoints; Index++)
+	{
+		if (Index < FirstResampledIndex && !DirtyPoints[Index])
+		{
+			continue;
+		}
+
+		SplineSamples.Locations[Index] = SplineComponent->GetLocationAtSplinePoint(Index, LocalSpace);
+		SplineSamples.Tangents[Index] = SplineComponent->GetTangentAtSplinePoint(Index, LocalSpace);
+		SplineSamples.Directions[Index] = SplineComponent->GetDirectionAtSplinePoint(Index, LocalSpace);
+		SplineSamples.Rotations[Index] = SplineComponent->GetRotationAtSplinePoint(Index, LocalSpace);
+		SplineSamples.Scales[Index] = SplineComponent->GetScaleAtSplinePoint(Index);
+	}
+}
+
+void AFlexSplineActor::UpdateSplineFrames()
+{
+	FirstChangedFrameIndex = INDEX_NONE;
+
+	bool bUsesSplineFrames = false;
+	for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		bUsesSplineFrames |= UsesSplineFrames(MeshInitDataPair.Value);
+	}
+
+	TArray<FQuat>& Frames = SplineSamples.Frames;
+	if (!bUsesSplineFrames)
+	{
+		Frames.Reset();
+		return;
+	}
+
+	// A frame depends on all samples before it, so frames are carried along again from the first changed sample on
+	const int32 NumSplinePoints = SplineSamples.Num();
+	const int32 FirstDirtyIndex = DirtyPoints.Find(true);
+	int32 FirstIndex = FirstShiftedPointIndex != INDEX_NONE ? FirstShiftedPointIndex : NumSplinePoints;
+	FirstIndex = FirstDirtyIndex != INDEX_NONE ? FMath::Min(FirstIndex, FirstDirtyIndex) : FirstIndex;
+	if (bFullRebuild || Frames.Num() != NumSplinePoints)
+	{
+		FirstIndex = 0;
+	}
+	if (FirstIndex >= NumSplinePoints)
+	{
+		return;
+	}
+
+	// Loops spread the twist left at the closing segment over all frames, which changes all of them
+	const bool bClosedLoop = SplineComponent->IsClosedLoop() && NumSplinePoints > 1;
+	if (bClosedLoop)
+	{
+		FirstIndex = 0;
+	}
+
+	// Carry a frame from the point at @param Index to the next point, in several steps along the curve
+	auto TransportAlongSegment = [this, NumSplinePoints](const FQuat& Frame, int32 Index)
+	{
+		const int32 NextIndex = (Index + 1) % NumSplinePoints;
+		FQuat StepFrame = Frame;
+		FVector StepLocation = SplineSamples.Locations[Index];
+		for (int32 Step = 1; Step <= SplineFrameSubsteps; Step++)
+		{
+			const float InputKey = Index + static_cast<float>(Step) / SplineFrameSubsteps;
+			const bool bLastStep = Step == SplineFrameSubsteps;
+			const FVector NextLocation = bLastStep ? SplineSamples.Locations[NextIndex] : SplineComponent->GetLocationAtSplineInputKey(InputKey, LocalSpace);
+			const FVector NextDirection = bLastStep ? SplineSamples.Directions[NextIndex] : SplineComponent->GetDirectionAtSplineInputKey(InputKey, LocalSpace);
+			StepFrame = TransportFrame(StepFrame, StepLocation, NextLocation, NextDirection);
+			StepLocation = NextLocation;
+		}
+		return StepFrame;
+	};
+
+	TArray<FQuat, TMemStackAllocator<>> NewFrames;
+	NewFrames.SetNumUninitialized(NumSplinePoints - FirstIndex);
+	for (int32 Index = FirstIndex; Index < NumSplinePoints; Index++)
+	{
+		NewFrames[Index - FirstIndex] = Index == 0
+			? SplineSamples.Directions[0].Rotation().Quaternion()
+			: TransportAlongSegment(Index == FirstIndex ? Frames[Index - 1] : NewFrames[Index - FirstIndex - 1], Index - 1);
+	}
+
+	if (bClosedLoop)
+	{
+		// Roll needed to turn the frame carried around the whole loop into the first frame, distributed evenly
+		const FQuat ClosingFrame = TransportAlongSegment(NewFrames.Last(), NumSplinePoints - 1);
+		const FVector ClosingRight = ClosingFrame.GetRightVector();
+		const FVector FirstRight = NewFrames[0].GetRightVector();
+		const float Twist = FMath::Atan2((ClosingRight ^ FirstRight) | NewFrames[0].GetForwardVector(), ClosingRight | FirstRight);
+		for (int32 Index = 1; Index < NumSplinePoints; Index++)
+		{
+			NewFrames[Index] = NewFrames[Index] * FQuat(FVector::ForwardVector, Twist * Index / NumSplinePoints);
+		}
+	}
+
+	Frames.SetNum(NumSplinePoints);
+	for (int32 Index = FirstIndex; Index < NumSplinePoints; Index++)
+	{
+		const FQuat& NewFrame = NewFrames[Index - FirstIndex];
+		if (FirstChangedFrameIndex == INDEX_NONE && !(Frames[Index] == NewFrame))
+		{
+			FirstChangedFrameIndex = Index;
+		}
+		Frames[Index] = NewFrame;
+	}
+}
+
+void AFlexSplineActor::UpdateArcLengths()
+{
+	bool bPlacedByDistance = false;
+	for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		bPlacedByDistance |= MeshInitDataPair.Value.MeshInfo.IsPlacedByDistance();
+	}
+
+	FFlexArcLengthTable& ArcLengths = SplineSamples.ArcLengths;
+	if (!bPlacedByDistance)
+	{
+		ArcLengths.Reset();
+		return;
+	}
+
+	const int32 NumSplinePoints = SplineSamples.Num();
+	const int32 NumSegments = SplineComponent->IsClosedLoop() ? NumSplinePoints : FMath::Max(NumSplinePoints - 1, 0);
+	constexpr int32 SamplesPerSegment = FFlexArcLengthTable::SamplesPerSegment;
+
+	// A segment depends on its start and end point, a changed point dirties the point before it as well.
+	// Like samples, segments before the first shifted index are kept
+	int32 FirstResampledIndex = FirstShiftedPointIndex != INDEX_NONE ? FirstShiftedPointIndex : NumSegments;
+	if (bFullRebuild || (FirstShiftedPointIndex == INDEX_NONE && ArcLengths.NumSegments() != NumSegments))
+	{
+		FirstResampledIndex = 0;
+	}
+
+	ArcLengths.SegmentSamples.SetNum(NumSegments * SamplesPerSegment);
+	ArcLengths.SegmentDistances.SetNum(NumSegments + 1);
+	for (int32 Segment = 0; Segment < NumSegments; Segment++)
+	{
+		if (Segment < FirstResampledIndex && !DirtyPoints[Segment])
+		{
+			continue;
+		}
+
+		// Sum of chords between evenly spaced input keys
+		float* Samples = ArcLengths.SegmentSamples.GetData() + Segment * SamplesPerSegment;
+		FVector PreviousLocation = SplineSamples.Locations[Segment];
+		float Distance = 0.f;
+		for (int32 Sample = 0; Sample < SamplesPerSegment; Sample++)
+		{
+			const float InputKey = Segment + static_cast<float>(Sample + 1) / SamplesPerSegment;
+			const FVector Location = SplineComponent->GetLocationAtSplineInputKey(InputKey, LocalSpace);
+			Distance += FVector::Dist(PreviousLocation, Location);
+			Samples[Sample] = Distance;
+			PreviousLocation = Location;
+		}
+	}
+
+	// Segment distances follow from the lengths of all segments before them
+	ArcLengths.SegmentDistances[0] = 0.f;
+	for (int32 Segment = 0; Segment < NumSegments; Segment++)
+	{
+		ArcLengths.SegmentDistances[Segment + 1] = ArcLengths.SegmentDistances[Segment] + ArcLengths.SegmentSamples[(Segment + 1) * SamplesPerSegment - 1];
+	}
+}
+
+void AFlexSplineActor::UpdatePlacementMasks()
+{
+	const int32 NumSplinePoints = PointDataArray.Num();
+	const int32 FinalIndex = NumSplinePoints - 1;
+	TArray<int32, TMemStackAllocator<>> PointIDs;
+	TArray<float, TMemStackAllocator<>> SpawnRolls;
+
+	for (TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
+		const bool bCanLoop = GetCanLoop(MeshInitData);
+		const uint32 PlacementHash = GetPlacementHash(MeshInitData, bCanLoop);
+
+		// Masks are index based. Points before the first shifted index keep their bits, except for the end of the spline.
+		// Without a loop the render modes treat the second to last point as the tail, so one more point is affected
+		const int32 NumTailPoints = bCanLoop ? 2 : 3;
+		int32 FirstIndex = NumSplinePoints;
+		if (PlacementHash != MeshInitData.PlacementHash)
+		{
+			FirstIndex = 0;
+		}
+		else if (FirstShiftedPointIndex != INDEX_NONE || MeshInitData.PlacementMask.Num() != NumSplinePoints)
+		{
+			const int32 FirstChangedIndex = FirstShiftedPointIndex != INDEX_NONE
+				? FirstShiftedPointIndex
+				: FMath::Min(MeshInitData.PlacementMask.Num(), NumSplinePoints);
+			FirstIndex = FMath::Clamp(FMath::Min(FirstChangedIndex, NumSplinePoints - NumTailPoints), 0, NumSplinePoints);
+		}
+
+		MeshInitData.PlacementHash = PlacementHash;
+		MeshInitData.PlacementMask.SetNum(NumSplinePoints, false);
+		if (FirstIndex >= NumSplinePoints)
+		{
+			continue;
+		}
+
+		// Roll spawn chances of all affected points in one batch
+		const int32 NumAffected = NumSplinePoints - FirstIndex;
+		PointIDs.SetNumUninitialized(NumAffected, false);
+		SpawnRolls.SetNumUninitialized(NumAffected, false);
+		for (int32 Index = FirstIndex; Index < NumSplinePoints; Index++)
+		{
+			PointIDs[Index - FirstIndex] = PointDataArray[Index].ID;
+		}
+		FFlexRandom::FillUnit(MeshInitData.LayerSeed, PointIDs, EFlexRandomChannel::SpawnChance, SpawnRolls);
+
+		const bool bActive = TEST_BIT(MeshInitData.GeneralInfo, EFlexGeneralFlags::Active);
+		for (int32 Index = FirstIndex; Index < NumSplinePoints; Index++)
+		{
+			MeshInitData.PlacementMask[Index] = bActive // Inactive
+				&& !(Index == FinalIndex && !bCanLoop) // No loop, so cut out last mesh
+				&& CanRenderFromSpawnChance(MeshInitData, Index, SpawnRolls[Index - FirstIndex]) // Spawn chance too low
+				&& CanRenderFromMode(MeshInitData, Index, FinalIndex); // Render-Mode check
+		}
+	}
+}
+
+void AFlexSplineActor::UpdatePointData()
+{
+	const int32 PointDataArraySize = PointDataArray.Num();
+	for (int32 Index = 0; Index < PointDataArraySize; Index++)
+	{
+		if (!IsPointDirty(Index))
+		{
+			continue;
+		}
+
+		FSplinePointData& PointData = PointDataArray[Index];
+
+		// Update location hash, used to match the point with the next construction
+		PointData.LocationHash = GeneratePointHashValue(SplineComponent, Index);
+	}
+}
+
+void AFlexSplineActor::UpdateDebugInformation()
+{
+#if WITH_EDITORONLY_DATA
+	if (DebugComponent == nullptr)
+	{
+		return;
+	}
+
+	// Nothing is kept while nothing is shown, showing debug information again refreshes all points
+	if (!IsDebugInformationShown())
+	{
+		DebugComponent->Reset();
+		return;
+	}
+
+	const int32 PointDataArraySize = PointDataArray.Num();
+	const bool bRefreshAll = bDebugRefreshPending || DebugComponent->IsEmpty();
+	DebugComponent->SetNum(PointDataArraySize, MeshDataInitMap.Num());
+	DebugComponent->bShowLabels = bShowPointNumbers;
+	DebugComponent->LabelColor = TextRenderColor;
+	DebugComponent->LabelWorldSize = PointNumberSize;
+
+	const FTransform& SplineTransform = SplineComponent->GetComponentTransform();
+	for (int32 Index = 0; Index < PointDataArraySize; Index++)
+	{
+		// Shifted points show a new index, even if their meshes did not change. Changed frames turn up directions
+		const bool bShifted = FirstShiftedPointIndex != INDEX_NONE && Index >= FirstShiftedPointIndex;
+		const bool bFrameChanged = FirstChangedFrameIndex != INDEX_NONE && Index >= FirstChangedFrameIndex - 1;
+		if (!IsPointDirty(Index) && !bShifted && !bFrameChanged && !bRefreshAll)
+		{
+			continue;
+		}
+
+		const FVector LabelLocation = GetTextPosition(Index);
+		DebugComponent->SetLabel(Index, LabelLocation);
+
+		// Up direction of each layer's spline mesh, above the point number
+		for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+		{
+			const FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
+			const USplineMeshComponent* SplineMesh = Cast<USplineMeshComponent>(MeshInitData.MeshComponentsArray[Index].Get());
+
+			if (MeshInitData.UpVectorInfo.bShowUpDirection
+				&& SplineMesh != nullptr
+				&& Index != PointDataArraySize - 1)
+			{
+				const FVector Start = LabelLocation + FVector::UpVector * UpDirectionArrowOffset;
+				const FVector Direction = SplineTransform.TransformVectorNoScale(SplineMesh->GetSplineUpDir());
+				DebugComponent->SetArrow(Index, MeshInitData.LayerIndex, Start, Start + Direction * UpDirectionArrowSize * DebugArrowLength,
+										 GetColorForArrow(MeshInitData.LayerIndex));
+			}
+			else
+			{
+				DebugComponent->ClearArrow(Index, MeshInitData.LayerIndex);
+			}
+		}
+	}
+#endif
+}
+
+void AFlexSplineActor::CoalesceSegments(TArray<FFlexLayerSolve>& LayerSolves) const
+{
+	int32 LayerIndex = 0;
+	for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		const FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
+		FFlexLayerSolve& LayerSolve = LayerSolves[LayerIndex++];
+		if (!MeshInitData.MeshInfo.IsCoalesced() || !LayerSolve.bSolvedAll)
+		{
+			continue;
+		}
+
+		// All points have been solved, so results are indexed by point. Spans do not wrap around loops
+		const FFlexMeshInfo& MeshInfo = MeshInitData.MeshInfo;
+		const TArrayView<FFlexMeshSolveResult> Results = LayerSolve.Results;
+		int32 First = 0;
+		while (First < Results.Num())
+		{
+			int32 Last = First;
+			if (Results[First].bVisible)
+			{
+				while (Last + 1 < Results.Num()
+					   && Last + 1 - First < MaxCoalescedSegments
+					   && CanCoalesce(Results, First, Last + 1, MeshInfo.CoalesceAngleTolerance, MeshInfo.CoalesceScaleTolerance))
+				{
+					Last++;
+				}
+			}
+
+			if (Last > First)
+			{
+				CoalesceSpan(Results, First, Last);
+			}
+			First = Last + 1;
+		}
+	}
+}
+
+uint32 AFlexSplineActor::GetConstructionInputHash() const
+{
+	// Point input hashes and layer config hashes of the current construction cover the spline, point data and layer settings.
+	// The hash is saved with the actor, so it is built from stable content only
+	uint32 Hash = HashCombine(ConstructionCacheVersion, static_cast<uint32>(PointInputHashes.Num()));
+	Hash = HashCombine(Hash, static_cast<uint32>(bWasClosedLoop));
+	for (int32 Index = 0; Index < PointInputHashes.Num(); Index++)
+	{
+		Hash = HashCombine(Hash, PointInputHashes[Index]);
+		Hash = HashCombine(Hash, static_cast<uint32>(PointDataArray[Index].ID));
+	}
+	for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		const FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
+		Hash = HashCombine(Hash, FCrc::StrCrc32(*MeshInitDataPair.Key.ToString()));
+		Hash = HashCombine(Hash, GetLayerConfigHash(MeshInitData, GetCanLoop(MeshInitData), SynchronizeConfig, true));
+	}
+	return Hash != 0 ? Hash : 1;
+}
+
+bool AFlexSplineActor::ReadConstructionCache(TArray<FFlexLayerSolve>& OutLayerSolves)
+{
+	// Only used if all meshes would be placed again anyway, which is the case for the first construction after load
+	if (!bFullRebuild
+		|| ConstructionCache.InputHash == 0
+		|| ConstructionCache.Layers.Num() != MeshDataInitMap.Num()
+		|| ConstructionCache.InputHash != GetConstructionInputHash())
+	{
+		return false;
+	}
+
+	// Validate all layers before touching any of them
+	const int32 NumSplinePoints = PointDataArray.Num();
+	int32 LayerIndex = 0;
+	for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		const FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
+		const FFlexLayerConstructionCache& LayerCache = ConstructionCache.Layers[LayerIndex++];
+		const bool bSplineMesh = MeshInitData.MeshInfo.MeshType == EFlexSplineMeshType::SplineMesh;
+		const int32 NumResults = MeshInitData.IsSolvedPerPoint() ? LayerCache.VisibleIndices.Num() : 0;
+
+		if (LayerCache.LayerName != MeshInitDataPair.Key
+			|| LayerCache.SplineParams.Num() != (bSplineMesh ? NumResults : 0)
+			|| LayerCache.Transforms.Num() != (bSplineMesh ? 0 : NumResults)
+			|| (LayerCache.VisibleIndices.Num() > 0 && !PointDataArray.IsValidIndex(LayerCache.VisibleIndices.Last())))
+		{
+			return false;
+		}
+	}
+
+	// Cached placements become the solve results of all points
+	OutLayerSolves.SetNum(MeshDataInitMap.Num());
+	LayerIndex = 0;
+	for (TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
+		const FFlexLayerConstructionCache& LayerCache = ConstructionCache.Layers[LayerIndex];
+		FFlexLayerSolve& LayerSolve = OutLayerSolves[LayerIndex++];
+		const bool bSplineMesh = MeshInitData.MeshInfo.MeshType == EFlexSplineMeshType::SplineMesh;
+		const bool bHasResults = MeshInitData.IsSolvedPerPoint();
+		const ECollisionEnabled::Type Collision = GetCollisionEnabled(MeshInitData);
+
+		LayerSolve.Reset();
+		LayerSolve.bSolvedAll = true;
+		LayerSolve.Indices.SetNumUninitialized(NumSplinePoints);
+		for (int32 Index = 0; Index < NumSplinePoints; Index++)
+		{
+			LayerSolve.Indices[Index] = Index;
+		}
+		LayerSolve.Results.AddDefaulted(NumSplinePoints);
+
+		MeshInitData.PlacementMask.SetNum(NumSplinePoints, false);
+		MeshInitData.PlacementMask.SetRange(0, NumSplinePoints, false);
+		MeshInitData.PlacementHash = GetPlacementHash(MeshInitData, GetCanLoop(MeshInitData));
+		for (int32 CacheIndex = 0; CacheIndex < LayerCache.VisibleIndices.Num(); CacheIndex++)
+		{
+			const int32 Index = LayerCache.VisibleIndices[CacheIndex];
+			MeshInitData.PlacementMask[Index] = true;
+			if (!bHasResults)
+			{
+				continue;
+			}
+
+			FFlexMeshSolveResult& Result = LayerSolve.Results[Index];
+			Result.bVisible = true;
+			Result.Collision = Collision;
+			if (bSplineMesh)
+			{
+				Result.SplineParams = LayerCache.SplineParams[CacheIndex];
+			}
+			else
+			{
+				Result.Transform = LayerCache.Transforms[CacheIndex];
+			}
+		}
+	}
+	return true;
+}
+
+#if WITH_EDITOR
+void AFlexSplineActor::WriteConstructionCache()
+{
+	// Only the result of a complete construction can be cached. Otherwise, e.g. when cooking actors that have not been
+	// constructed, the cache saved before is kept, its input hash still guards against stale data
+	const int32 NumSplinePoints = PointDataArray.Num();
+	if (SplineComponent->GetNumberOfSplinePoints() != NumSplinePoints
+		|| PointInputHashes.Num() != NumSplinePoints
+		|| SplineSamples.Num() != NumSplinePoints)
+	{
+		return;
+	}
+	for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		if (MeshInitDataPair.Value.PlacementMask.Num() != NumSplinePoints)
+		{
+			return;
+		}
+	}
+
+	TArray<FFlexLayerSolve> LayerSolves;
+	SolveMeshComponents(LayerSolves, true);
+
+	ConstructionCache = FFlexConstructionCache();
+	int32 LayerIndex = 0;
+	for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		const FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
+		const FFlexLayerSolve& LayerSolve = LayerSolves[LayerIndex++];
+		const bool bSplineMesh = MeshInitData.MeshInfo.MeshType == EFlexSplineMeshType::SplineMesh;
+		const bool bHasResults = MeshInitData.IsSolvedPerPoint();
+
+		FFlexLayerConstructionCache& LayerCache = ConstructionCache.Layers.AddDefaulted_GetRef();
+		LayerCache.LayerName = MeshInitDataPair.Key;
+		for (TConstSetBitIterator<> It(MeshInitData.PlacementMask); It; ++It)
+		{
+			const int32 Index = It.GetIndex();
+			LayerCache.VisibleIndices.Add(Index);
+			if (bHasResults && bSplineMesh)
+			{
+				LayerCache.SplineParams.Add(LayerSolve.Results[Index].SplineParams);
+			}
+			else if (bHasResults)
+			{
+				LayerCache.Transforms.Add(LayerSolve.Results[Index].Transform);
+			}
+		}
+	}
+
+	ConstructionCache.InputHash = GetConstructionInputHash();
+}
+#endif
+
+void AFlexSplineActor::UpdateMeshComponents(const TArray<FFlexLayerSolve>& LayerSolves)
+{
+	// Apply phase: push solved placements to components on the game thread
+	int32 NumUpdatedComponents = 0;
+	int32 NumSkippedComponents = 0;
+	int32 LayerIndex = 0;
+	for (TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
+		const FFlexLayerSolve& LayerSolve = LayerSolves[LayerIndex++];
+		UClass* ConfiguredMeshType = GetMeshType(MeshInitData);
+
+		for (int32 SolveIndex = 0; SolveIndex < LayerSolve.Indices.Num(); SolveIndex++)
+		{
+			const int32 Index = LayerSolve.Indices[SolveIndex];
+			const FFlexMeshSolveResult& Result = LayerSolve.Results[SolveIndex];
+			UStaticMeshComponent* MeshComp = MeshInitData.MeshComponentsArray[Index].Get();
+			UClass* MeshType = MeshComp != nullptr ? MeshComp->GetClass() : nullptr;
+
+			// Only points that render own a component, replace it if the type has changed
+			UClass* RequiredMeshType = Result.bVisible ? ConfiguredMeshType : nullptr;
+			if (RequiredMeshType != MeshType)
+			{
+				ReleaseMeshComponent(ComponentPool, MeshInitData, Index);
+				CreateMeshComponent(RequiredMeshType, MeshInitData, Index);
+				MeshComp = MeshInitData.MeshComponentsArray[Index].Get();
+				MeshType = RequiredMeshType;
+			}
+
+			// Nothing to update for hidden points and layers without per point components
+			if (MeshComp == nullptr)
+			{
+				continue;
+			}
+
+			// Update type agnostic mesh settings, components whose effective parameters did not change are left alone
+			FFlexAppliedMeshState& AppliedState = MeshInitData.AppliedMeshStates[Index];
+			bool bUpdated = ApplyMeshSettings(MeshComp, MeshInitData, Result.Collision, AppliedState);
+
+			// Update type dependent mesh settings
+			if (MeshType == SplineMeshClass)
+			{
+				const uint32 PlacementHash = GetSplineMeshParamsHash(Result.SplineParams);
+				if (PlacementHash != AppliedState.PlacementHash)
+				{
+					UpdateSplineMesh(Cast<USplineMeshComponent>(MeshComp), Result.SplineParams);
+					AppliedState.PlacementHash = PlacementHash;
+					bUpdated = true;
+				}
+			}
+			else if (MeshType == StaticMeshClass)
+			{
+				const uint32 PlacementHash = GetTransformHash(Result.Transform);
+				if (PlacementHash != AppliedState.PlacementHash)
+				{
+					UpdateStaticMesh(MeshComp, Result.Transform);
+					AppliedState.PlacementHash = PlacementHash;
+					bUpdated = true;
+				}
+			}
+
+			if (bUpdated)
+			{
+				NumUpdatedComponents++;
+			}
+			else
+			{
+				NumSkippedComponents++;
+			}
+		}
+
+		// Material and collision changes only touch existing components, no mesh is placed again
+		if (TEST_BIT(MeshInitData.PendingUpdates, EFlexUpdateFlags::Material)
+			|| TEST_BIT(MeshInitData.PendingUpdates, EFlexUpdateFlags::Collision))
+		{
+			UpdateLayerSettings(MeshInitData);
+		}
+
+		// Instanced layers are updated in one batch, all other layers drop their instanced component
+		if (MeshInitData.MeshInfo.IsInstanced())
+		{
+			UpdateInstancedMesh(MeshInitData, LayerSolve);
+		}
+		else if (MeshInitData.InstancedMeshComponent.IsValid())
+		{
+			ReleaseInstancedMeshComponent(ComponentPool, MeshInitData);
+		}
+
+		// Same for baked layers and their merged meshes
+		if (MeshInitData.IsBaked())
+		{
+			UpdateBakedMesh(MeshInitData);
+		}
+		else if (MeshInitData.BakedMeshComponentsArray.Num() > 0)
+		{
+			ReleaseBakedMeshComponents(ComponentPool, MeshInitData);
+		}
+
+		// Same for dynamic layers, unless they are baked
+		if (MeshInitData.MeshInfo.IsDynamic() && !MeshInitData.IsBaked())
+		{
+			UpdateDynamicMesh(MeshInitData, LayerSolve);
+		}
+		else if (MeshInitData.DynamicMesh.Component.IsValid())
+		{
+			ReleaseDynamicMeshComponent(ComponentPool, MeshInitData);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_FlexSplineUpdatedComponents, NumUpdatedComponents);
+	SET_DWORD_STAT(STAT_FlexSplineSkippedComponents, NumSkippedComponents);
+}
+
+void AFlexSplineActor::SolveMeshComponents(TArray<FFlexLayerSolve>& OutLayerSolves, bool bSolveAll) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlexSplineSolve);
+
+	const int32 NumSplinePoints = PointDataArray.Num();
+	FMemMark MemMark(FMemStack::Get());
+	TArray<FFlexLayerKernel, TMemStackAllocator<>> LayerKernels;
+	TArray<int32, TMemStackAllocator<>> LayerOffsets;
+	int32 NumWorkItems = 0;
+	int32 NumSolvedPoints = 0;
+	const bool bPointsChanged = DirtyPoints.Find(true) != INDEX_NONE
+		|| FirstShiftedPointIndex != INDEX_NONE
+		|| FirstChangedFrameIndex != INDEX_NONE;
+
+	// Gather points to solve per layer, all work items are laid out back to back. Solves of the last construction keep their capacity
+	OutLayerSolves.SetNum(MeshDataInitMap.Num());
+	int32 LayerIndex = 0;
+	for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		const FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
+		FFlexLayerSolve& LayerSolve = OutLayerSolves[LayerIndex++];
+		LayerSolve.Reset();
+		LayerSolve.bSolvedAll = bSolveAll
+			|| bFullRebuild
+			|| NeedsAllPointsSolved(MeshInitData, NumSplinePoints, bPointsChanged)
+			|| HasPendingPlacementUpdate(MeshInitData);
+
+		if (LayerSolve.bSolvedAll)
+		{
+			LayerSolve.Indices.SetNumUninitialized(NumSplinePoints);
+			for (int32 Index = 0; Index < NumSplinePoints; Index++)
+			{
+				LayerSolve.Indices[Index] = Index;
+			}
+		}
+		else
+		{
+			// Frames carried along the spline change at all points after a changed one, the segment ending there included
+			const int32 FirstFrameIndex = UsesSplineFrames(MeshInitData) && FirstChangedFrameIndex != INDEX_NONE
+				? FMath::Max(FirstChangedFrameIndex - 1, 0)
+				: NumSplinePoints;
+			for (TConstSetBitIterator<> It(DirtyPoints); It && It.GetIndex() < FirstFrameIndex; ++It)
+			{
+				LayerSolve.Indices.Add(It.GetIndex());
+			}
+			for (int32 Index = FirstFrameIndex; Index < NumSplinePoints; Index++)
+			{
+				LayerSolve.Indices.Add(Index);
+			}
+		}
+		LayerSolve.Results.AddDefaulted(LayerSolve.Indices.Num());
+
+		// Settings that are constant per layer are resolved once, they select the kernel that solves the layer's points.
+		// Baked layers render their merged meshes and layers placed by distance are not bound to points,
+		// their points are only visited to remove stale components
+		const int32 NumLayerPoints = MeshInitData.IsSolvedPerPoint() ? LayerSolve.Indices.Num() : 0;
+		LayerKernels.Add(FFlexLayerKernel::Make(MeshInitData, GetCollisionEnabled(MeshInitData), SynchronizeConfig));
+		LayerOffsets.Add(NumWorkItems);
+		NumWorkItems += FMath::DivideAndRoundUp(NumLayerPoints, SolveBatchSize);
+		NumSolvedPoints += NumLayerPoints;
+	}
+
+	const FFlexSolveContext Context{SplineSamples, PointDataArray};
+	const bool bGenericSolve = CVarFlexSplineGenericSolve.GetValueOnGameThread() != 0;
+	ParallelFor(NumWorkItems, [&](int32 WorkItem)
+	{
+		// Last layer starting at or before this work item
+		const int32 SolvedLayer = Algo::UpperBound(LayerOffsets, WorkItem) - 1;
+		const int32 FirstSolveIndex = (WorkItem - LayerOffsets[SolvedLayer]) * SolveBatchSize;
+		FFlexLayerSolve& LayerSolve = OutLayerSolves[SolvedLayer];
+		const FFlexLayerKernel& Kernel = LayerKernels[SolvedLayer];
+		const int32 NumBatchPoints = FMath::Min(SolveBatchSize, LayerSolve.Indices.Num() - FirstSolveIndex);
+
+		if (bGenericSolve)
+		{
+			for (int32 SolveIndex = FirstSolveIndex; SolveIndex < FirstSolveIndex + NumBatchPoints; SolveIndex++)
+			{
+				SolveMesh(*Kernel.MeshInitData, LayerSolve.Indices[SolveIndex], LayerSolve.Results[SolveIndex]);
+			}
+		}
+		else
+		{
+			Kernel.Solve(Context, Kernel,
+						 MakeArrayView(LayerSolve.Indices.GetData() + FirstSolveIndex, NumBatchPoints),
+						 MakeArrayView(LayerSolve.Results.GetData() + FirstSolveIndex, NumBatchPoints));
+		}
+	}, NumSolvedPoints < ParallelSolveMinItems);
+}
+
+void AFlexSplineActor::SolveMesh(const FSplineMeshInitData& MeshInitData, int32 Index, FFlexMeshSolveResult& OutResult) const
+{
+	OutResult.bVisible = CanRender(MeshInitData, Index);
+	if (!OutResult.bVisible)
+	{
+		OutResult.Collision = ECollisionEnabled::NoCollision;
+		return;
+	}
+
+	OutResult.Collision = GetCollisionEnabled(MeshInitData);
+	if (MeshInitData.MeshInfo.MeshType == EFlexSplineMeshType::SplineMesh)
+	{
+		OutResult.SplineParams = CalculateSplineMeshParams(MeshInitData, Index);
+	}
+	else
+	{
+		const FSplinePointData& PointData = PointDataArray[Index];
+		OutResult.Transform = FTransform(CalculateRotation(MeshInitData, PointData, Index),
+										 CalculateLocation(MeshInitData, PointData, Index),
+										 CalculateScale(MeshInitData, PointData, Index));
+	}
+}
+
+void AFlexSplineActor::UpdateLayerSettings(FSplineMeshInitData& MeshInitData)
+{
+	// Per point components only exist for rendered points
+	const ECollisionEnabled::Type Collision = GetCollisionEnabled(MeshInitData);
+	for (int32 Index = 0; Index < MeshInitData.MeshComponentsArray.Num(); Index++)
+	{
+		UStaticMeshComponent* MeshComp = MeshInitData.MeshComponentsArray[Index].Get();
+		if (MeshComp != nullptr)
+		{
+			ApplyMeshSettings(MeshComp, MeshInitData, Collision, MeshInitData.AppliedMeshStates[Index]);
+		}
+	}
+
+	UHierarchicalInstancedStaticMeshComponent* InstancedMesh = MeshInitData.InstancedMeshComponent.Get();
+	if (InstancedMesh != nullptr)
+	{
+		InstancedMesh->SetCollisionProfileName(MeshInitData.PhysicsInfo.CollisionProfileName);
+		InstancedMesh->SetCollisionEnabled(TEST_BIT(MeshInitData.GeneralInfo, EFlexGeneralFlags::Active)
+										   ? Collision
+										   : ECollisionEnabled::NoCollision);
+		InstancedMesh->SetGenerateOverlapEvents(MeshInitData.PhysicsInfo.bGenerateOverlapEvent);
+		InstancedMesh->SetMaterial(0, MeshInitData.MeshInfo.MeshMaterial);
+	}
+}
+
+void AFlexSplineActor::UpdateSplineMesh(USplineMeshComponent* SplineMesh, const FFlexSplineMeshParams& Params)
+{
+	if (SplineMesh != nullptr)
+	{
+		// Set spline params
+		SplineMesh->SetRelativeLocation(Params.RelativeLocation);
+		SplineMesh->SetRelativeRotation(Params.RelativeRotation);
+		SplineMesh->SetRelativeScale3D(FVector(Params.RelativeScaleX, SplineMesh->GetRelativeScale3D().Y, SplineMesh->GetRelativeScale3D().Z));
+		SplineMesh->SetStartAndEnd(Params.StartLocation, Params.StartTangent, Params.EndLocation, Params.EndTangent, false);
+		SplineMesh->SetStartOffset(Params.StartOffset, false);
+		SplineMesh->SetEndOffset(Params.EndOffset, false);
+		SplineMesh->SetSplineUpDir(Params.UpDirection, false);
+		SplineMesh->SetForwardAxis(ToSplineAxis(Params.ForwardAxis), false);
+
+		// Apply spline point data
+		SplineMesh->SetStartRoll(Params.StartRoll, false);
+		SplineMesh->SetEndRoll(Params.EndRoll, false);
+		SplineMesh->SetStartScale(Params.StartScale, false);
+		SplineMesh->SetEndScale(Params.EndScale, false);
+		SplineMesh->UpdateMesh();
 	}
-	return Count;
 }
 
-
-//////////////////////////////////////////////////////////////////////////
-// FLEX SPLINE FUNCTIONALITY
-void AFlexSplineActor::ConstructSplineMesh()
+void AFlexSplineActor::UpdateStaticMesh(UStaticMeshComponent* StaticMesh, const FTransform& Transform)
 {
-	// Get all indices that were deleted, if any
-	TArray<int32> DeletedIndices;
-	GetDeletedIndices(DeletedIndices);
-
-	InitializeNewMeshData();
-
-	// Check if number of spline points and point data align, add or remove data accordingly
-	AddPointDataEntries();
-	RemovePointDataEntries(DeletedIndices);
-
-	// Check if number of spline points and meshes align, add or remove meshes accordingly
-	InitDataAddMeshes();
-	InitDataRemoveMeshes(DeletedIndices);
-
-	// Update the spline itself with the gathered data
-	UpdatePointData();
-	UpdateMeshComponents();
-	UpdateDebugInformation();
+	if (StaticMesh != nullptr)
+	{
+		// Apply mesh-init configurations
+		StaticMesh->SetRelativeTransform(Transform);
+	}
 }
 
-void AFlexSplineActor::InitializeNewMeshData()
+void AFlexSplineActor::UpdateInstancedMesh(FSplineMeshInitData& MeshInitData, const FFlexLayerSolve& LayerSolve)
 {
-	const int32 MeshInitMapNum = MeshDataInitMap.Num();
+	UHierarchicalInstancedStaticMeshComponent* InstancedMesh = MeshInitData.InstancedMeshComponent.Get();
+	if (InstancedMesh == nullptr)
+	{
+		InstancedMesh = CreateInstancedMeshComponent(MeshInitData);
+		MeshInitData.InstanceIndices.Reset();
+	}
 
-	for (TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	const int32 NumSplinePoints = SplineComponent->GetNumberOfSplinePoints();
+	const bool bPlacedByDistance = MeshInitData.MeshInfo.IsPlacedByDistance();
+
+	// Unless all points have been solved, layer settings and visibility are unchanged, so only changed instances are moved
+	if (!LayerSolve.bSolvedAll && MeshInitData.InstanceIndices.Num() == NumSplinePoints)
 	{
-		FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
-		if (!MeshInitData.IsInitialized())
+		// Writing instances marks the render state dirty, constructions without changes do not touch it
+		if (bPlacedByDistance)
 		{
-			// Generate name for new entry
-			for (int32 Index = 0; Index < MeshInitMapNum; Index++)
+			UpdateDistanceInstances(MeshInitData, InstancedMesh, false);
+			return;
+		}
+
+		for (int32 SolveIndex = 0; SolveIndex < LayerSolve.Indices.Num(); SolveIndex++)
+		{
+			const int32 InstanceIndex = MeshInitData.InstanceIndices[LayerSolve.Indices[SolveIndex]];
+			if (InstanceIndex != INDEX_NONE)
 			{
-				const FName NewLayerName = FName(*FString(TEXT("Layer " + FString::FromInt(Index))));
-				if ( !MeshDataInitMap.Contains(NewLayerName) && NewLayerName != LastUsedKey )
-				{
-					MeshInitDataPair.Key = NewLayerName;
-					LastUsedKey = NewLayerName;
-					break;
-				}
+				InstancedMesh->UpdateInstanceTransform(InstanceIndex, LayerSolve.Results[SolveIndex].Transform, false, false, true);
 			}
-
-			// Init data from template
-			MeshInitData = MeshDataTemplate;
-			MeshInitData.Initialize();
 		}
+		if (LayerSolve.Indices.Num() > 0)
+		{
+			InstancedMesh->MarkRenderStateDirty();
+		}
+		return;
 	}
-}
 
-void AFlexSplineActor::AddPointDataEntries()
-{
-	const int32 PointDataArraySize = PointDataArray.Num();
-	const int32 NumberOfSplinePoints = SplineComponent->GetNumberOfSplinePoints();
-
-	for (int32 i = PointDataArraySize; i < NumberOfSplinePoints; i++)
+	// Update settings shared by all instances
+	InstancedMesh->SetCollisionProfileName(MeshInitData.PhysicsInfo.CollisionProfileName);
+	InstancedMesh->SetVisibility(TEST_BIT(MeshInitData.GeneralInfo, EFlexGeneralFlags::Active));
+	InstancedMesh->SetCollisionEnabled(TEST_BIT(MeshInitData.GeneralInfo, EFlexGeneralFlags::Active)
+									   ? GetCollisionEnabled(MeshInitData)
+									   : ECollisionEnabled::NoCollision);
+	InstancedMesh->SetGenerateOverlapEvents(MeshInitData.PhysicsInfo.bGenerateOverlapEvent);
+	InstancedMesh->SetMobility(EComponentMobility::Movable); // <- Required for SetStaticMesh to work correctly
+	InstancedMesh->SetStaticMesh(MeshInitData.MeshInfo.Mesh);
+	InstancedMesh->SetMobility(EComponentMobility::Static);
+	InstancedMesh->SetMaterial(0, MeshInitData.MeshInfo.MeshMaterial);
+
+	if (bPlacedByDistance)
 	{
-		FSplinePointData NewPointData;
+		UpdateDistanceInstances(MeshInitData, InstancedMesh, true);
+		return;
+	}
 
-		// Create text renderer to show point index in editor
-		UTextRenderComponent* NewTextRender = NewObject<UTextRenderComponent>(RootComponent);
-		NewTextRender->RegisterComponent();
-		NewTextRender->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
-		NewTextRender->SetWorldSize(PointNumberSize);
-		NewTextRender->SetHiddenInGame(true);
-		NewTextRender->SetTextRenderColor(TextRenderColor);
-		NewPointData.IndexTextRenderer = NewTextRender;
+	// Gather transforms of all visible instances, all points have been solved for this layer
+	check(LayerSolve.bSolvedAll);
+	TArray<FTransform>& InstanceTransforms = ScratchInstanceTransforms;
+	InstanceTransforms.Reset();
+	MeshInitData.InstanceIndices.Init(INDEX_NONE, NumSplinePoints);
 
-		// Save entry
-		PointDataArray.Add(NewPointData);
+	for (int32 Index = 0; Index < NumSplinePoints; Index++)
+	{
+		const FFlexMeshSolveResult& Result = LayerSolve.Results[Index];
+		if (Result.bVisible)
+		{
+			MeshInitData.InstanceIndices[Index] = InstanceTransforms.Num();
+			InstanceTransforms.Add(Result.Transform);
+		}
+	}
+
+	// Write all instances at once, only rebuild instance buffer if the instance count has changed
+	if (InstancedMesh->GetInstanceCount() == InstanceTransforms.Num())
+	{
+		InstancedMesh->BatchUpdateInstancesTransforms(0, InstanceTransforms, false, true, false);
+	}
+	else
+	{
+		InstancedMesh->ClearInstances();
+		InstancedMesh->AddInstances(InstanceTransforms, false);
 	}
 }
 
-void AFlexSplineActor::RemovePointDataEntries(const TArray<int32>& DeletedIndices)
+void AFlexSplineActor::UpdateDistanceInstances(FSplineMeshInitData& MeshInitData, UHierarchicalInstancedStaticMeshComponent* InstancedMesh, bool bUpdateAll)
 {
-	// Use gathered indices to clean up and delete redundant data
-	for (const int32 Index : DeletedIndices)
+	const FFlexArcLengthTable& ArcLengths = SplineSamples.ArcLengths;
+	const int32 NumSplinePoints = PointDataArray.Num();
+	const int32 NumSegments = FMath::Min(ArcLengths.NumSegments(), NumSplinePoints);
+	const float Spacing = FMath::Max(MeshInitData.MeshInfo.PlacementSpacing, MinPlacementSpacing);
+	TArray<int32>& FirstSegmentInstances = MeshInitData.InstanceIndices;
+
+	// Meshes behind a changed segment slide along the spline, so all of them are placed again. Meshes before it stay
+	int32 FirstSegment = 0;
+	if (!bUpdateAll && FirstSegmentInstances.Num() == NumSplinePoints)
 	{
-		const FSplinePointData& PointData = PointDataArray[Index];
+		const int32 FirstDirtyIndex = DirtyPoints.Find(true);
+		FirstSegment = FirstShiftedPointIndex != INDEX_NONE ? FirstShiftedPointIndex : NumSplinePoints;
+		FirstSegment = FirstDirtyIndex != INDEX_NONE ? FMath::Min(FirstSegment, FirstDirtyIndex) : FirstSegment;
+		if (UsesSplineFrames(MeshInitData) && FirstChangedFrameIndex != INDEX_NONE)
+		{
+			FirstSegment = FMath::Min(FirstSegment, FMath::Max(FirstChangedFrameIndex - 1, 0));
+		}
+		if (FirstSegment >= NumSplinePoints)
+		{
+			return;
+		}
+	}
 
-		// Remove this point's text-render
-		UTextRenderComponent* IndexText = PointData.IndexTextRenderer;
-		if (IndexText != nullptr)
+	// Count meshes by their distance along the spline, so randomized values stick to a place on the spline.
+	// Segments of points that do not render, and the end of an open spline, stay empty
+	FMemMark MemMark(FMemStack::Get());
+	TArray<int32, TMemStackAllocator<>> MeshIndices;
+	const int32 FirstInstance = FirstSegment > 0 ? FirstSegmentInstances[FirstSegment] : 0;
+	FirstSegmentInstances.SetNum(NumSplinePoints);
+	for (int32 Segment = FirstSegment; Segment < NumSplinePoints; Segment++)
+	{
+		FirstSegmentInstances[Segment] = FirstInstance + MeshIndices.Num();
+		if (Segment >= NumSegments || !MeshInitData.PlacementMask[Segment])
 		{
-			IndexText->DestroyComponent();
+			continue;
 		}
 
-		// Remove arrows
-		for (TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+		const float SegmentEnd = ArcLengths.SegmentDistances[Segment + 1];
+		for (int32 MeshIndex = FMath::CeilToInt(ArcLengths.SegmentDistances[Segment] / Spacing); MeshIndex * Spacing < SegmentEnd; MeshIndex++)
 		{
-			FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
-			FArrowWeakPtr Arrow = MeshInitData.ArrowSplineUpIndicatorArray[Index];
-			if (Arrow.IsValid())
-			{
-				MeshInitData.ArrowSplineUpIndicatorArray.Remove(Arrow);
-				Arrow->DestroyComponent();
-			}
+			MeshIndices.Add(MeshIndex);
 		}
+	}
 
-		PointDataArray.RemoveAt(Index);
+	TArray<FTransform>& InstanceTransforms = ScratchInstanceTransforms;
+	InstanceTransforms.SetNumUninitialized(MeshIndices.Num(), false);
+	for (int32 Index = 0; Index < MeshIndices.Num(); Index++)
+	{
+		const int32 MeshIndex = MeshIndices[Index];
+		InstanceTransforms[Index] = CalculateDistanceTransform(MeshInitData, MeshIndex, ArcLengths.GetInputKeyAtDistance(MeshIndex * Spacing));
 	}
-}
 
-void AFlexSplineActor::InitDataAddMeshes()
-{
-	// Each mesh-init data stores all spline mesh components of its type, their location scattered across all spline points
-	// Here we add spline meshes until it has as many meshes as there are spline points
-	for (TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	// Instances before the first changed one keep their place in the instance buffer, only the rest is written
+	const int32 NumInstances = FirstInstance + InstanceTransforms.Num();
+	const int32 NumOldInstances = InstancedMesh->GetInstanceCount();
+	if (NumOldInstances == NumInstances)
 	{
-		FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
-		UClass* MeshType = GetMeshType(MeshInitData.MeshInfo.MeshType);
-		const int32 NumberOfSplinePoints = SplineComponent->GetNumberOfSplinePoints();
-		const int32 NumberOfSplineMeshes = MeshInitData.MeshComponentsArray.Num();
+		if (InstanceTransforms.Num() > 0)
+		{
+			InstancedMesh->BatchUpdateInstancesTransforms(FirstInstance, InstanceTransforms, false, true, false);
+		}
+		return;
+	}
 
-		if (NumberOfSplineMeshes < NumberOfSplinePoints)
+	if (FirstInstance == 0)
+	{
+		InstancedMesh->ClearInstances();
+	}
+	else if (NumOldInstances > FirstInstance)
+	{
+		TArray<int32>& RemovedInstances = ScratchRemovedInstances;
+		RemovedInstances.Reset();
+		for (int32 InstanceIndex = FirstInstance; InstanceIndex < NumOldInstances; InstanceIndex++)
 		{
-			for (int32 i = NumberOfSplineMeshes; i < NumberOfSplinePoints; i++)
-			{
-				CreateMeshComponent(MeshType, MeshInitData);
-				CreateArrowComponent(MeshInitData);
-			}
+			RemovedInstances.Add(InstanceIndex);
 		}
+		InstancedMesh->RemoveInstances(RemovedInstances);
 	}
+	InstancedMesh->AddInstances(InstanceTransforms, false);
 }
 
-void AFlexSplineActor::InitDataRemoveMeshes(const TArray<int32>& DeletedIndices)
+void AFlexSplineActor::UpdateDynamicMesh(FSplineMeshInitData& MeshInitData, const FFlexLayerSolve& LayerSolve)
 {
-	for (const int32 Index : DeletedIndices)
+	FFlexDynamicMeshState& DynamicMesh = MeshInitData.DynamicMesh;
+	UProceduralMeshComponent* MeshComp = DynamicMesh.Component.Get();
+	bool bFullUpdate = false;
+
+	if (MeshComp == nullptr)
+	{
+		MeshComp = CreateDynamicMeshComponent(MeshInitData);
+		bFullUpdate = true;
+	}
+
+	// Copy source mesh again if it has been swapped
+	UStaticMesh* Mesh = MeshInitData.MeshInfo.Mesh;
+	if (DynamicMesh.SourceMeshAsset.Get() != Mesh || !DynamicMesh.SourceMesh.IsValid())
 	{
-		// Remove all spline Meshes at this spline index (which was removed)
-		for (TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+		const bool bMeshSwapped = DynamicMesh.SourceMeshAsset.Get() != Mesh;
+		DynamicMesh.SourceMesh = MakeShared<FFlexDeformSourceMesh, ESPMode::ThreadSafe>();
+		if (!DynamicMesh.SourceMesh->Initialize(Mesh))
 		{
-			FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
-			const int32 NumberOfSplinePoints = SplineComponent->GetNumberOfSplinePoints();
-			const int32 NumberOfSplineMeshes = MeshInitData.MeshComponentsArray.Num();
+			DynamicMesh.SourceMesh.Reset();
 
-			if (NumberOfSplineMeshes > NumberOfSplinePoints)
+			// Only warn once per mesh, the copy is attempted again on every construction
+			if (bMeshSwapped && Mesh != nullptr)
 			{
-				DestroyMeshComponent(MeshInitData, Index);
+				UE_LOG(FlexLog, Warning, TEXT("Mesh Layer %s can not be deformed, its mesh has no render data readable by the CPU (Allow CPU Access)"), *MeshInitData.LayerName.ToString());
 			}
 		}
+		DynamicMesh.SourceMeshAsset = Mesh;
+		bFullUpdate = true;
 	}
-}
 
-void AFlexSplineActor::UpdatePointData()
-{
-	const int32 PointDataArraySize = PointDataArray.Num();
-	for (int32 Index = 0; Index < PointDataArraySize; Index++)
+	// Update type agnostic mesh settings. Setting the same profile again still refreshes the collision settings
+	const bool bActive = TEST_BIT(MeshInitData.GeneralInfo, EFlexGeneralFlags::Active);
+	const ECollisionEnabled::Type Collision = bActive ? GetCollisionEnabled(MeshInitData) : ECollisionEnabled::NoCollision;
+	const bool bCreateCollision = Collision != ECollisionEnabled::NoCollision;
+	if (MeshComp->GetCollisionProfileName() != MeshInitData.PhysicsInfo.CollisionProfileName)
 	{
-		FSplinePointData& PointData = PointDataArray[Index];
+		MeshComp->SetCollisionProfileName(MeshInitData.PhysicsInfo.CollisionProfileName);
+	}
+	MeshComp->SetVisibility(bActive);
+	MeshComp->SetCollisionEnabled(Collision);
+	MeshComp->SetGenerateOverlapEvents(MeshInitData.PhysicsInfo.bGenerateOverlapEvent);
 
-		// Update ID
-		PointData.ID = GeneratePointHashValue(SplineComponent, Index);
+	if (!DynamicMesh.SourceMesh.IsValid())
+	{
+		if (MeshComp->GetNumSections() > 0)
+		{
+			MeshComp->ClearAllMeshSections();
+		}
+		DynamicMesh.SegmentParams.Reset();
+		DynamicMesh.SegmentVisibility.Reset();
+		return;
 	}
-}
 
-void AFlexSplineActor::UpdateDebugInformation()
-{
-	const int32 PointDataArraySize = PointDataArray.Num();
-	for (int32 Index = 0; Index < PointDataArraySize; Index++)
+	// Collision is generated along with the geometry, so toggling it requires a full upload. Same for subdivision,
+	// which changes the geometry of all segments without changing their parameters
+	const int32 NumSplinePoints = SplineComponent->GetNumberOfSplinePoints();
+	const int32 NumChunks = FMath::DivideAndRoundUp(NumSplinePoints, DynamicMeshChunkSize);
+	const int32 NumMaterialSlots = FMath::Max(1, Mesh->StaticMaterials.Num());
+	const bool bSubdivide = MeshInitData.MeshInfo.bSubdivideSegments;
+	bFullUpdate |= DynamicMesh.bHasCollision != bCreateCollision
+		|| DynamicMesh.bSubdivided != bSubdivide
+		|| DynamicMesh.SegmentParams.Num() != NumSplinePoints;
+
+	// Update the parameters of all solved segments in place and find chunks that have changed since the last upload.
+	// Points that have not been solved keep their last uploaded parameters
+	TArray<FFlexSplineMeshParams>& SegmentParams = DynamicMesh.SegmentParams;
+	TBitArray<>& SegmentVisibility = DynamicMesh.SegmentVisibility;
+	TBitArray<TMemStackAllocator<>> DirtyChunks(bFullUpdate, NumChunks);
+	SegmentParams.SetNum(NumSplinePoints, false);
+	SegmentVisibility.SetNum(NumSplinePoints, false);
+
+	for (int32 SolveIndex = 0; SolveIndex < LayerSolve.Indices.Num(); SolveIndex++)
 	{
-		const FSplinePointData& PointData = PointDataArray[Index];
+		const int32 Index = LayerSolve.Indices[SolveIndex];
+		const FFlexMeshSolveResult& Result = LayerSolve.Results[SolveIndex];
+		const bool bVisible = Result.bVisible;
+		const bool bChanged = bVisible != SegmentVisibility[Index] || (bVisible && Result.SplineParams != SegmentParams[Index]);
 
-		// Update text renderer
-		UTextRenderComponent* TextRenderer = PointData.IndexTextRenderer;
-		if (TextRenderer != nullptr)
+		SegmentVisibility[Index] = bVisible;
+		if (bVisible)
 		{
-			const FRotator SplineRotation = SplineComponent->GetRotationAtSplinePoint(Index, LocalSpace);
-			TextRenderer->SetWorldLocation(GetTextPosition(Index));
-			TextRenderer->SetText(FText::AsNumber(Index));
-			TextRenderer->SetTextRenderColor(TextRenderColor);
-			TextRenderer->SetRelativeRotation(FRotator(0.f, -SplineRotation.Yaw, 0.f));
-			TextRenderer->SetWorldSize(PointNumberSize);
-			TextRenderer->SetVisibility(bShowPointNumbers);
+			SegmentParams[Index] = Result.SplineParams;
 		}
 
-		// Update up-vector-arrow
-		int32 MeshInitIndex = 0;
-		for (auto& MeshInitDataPair : MeshDataInitMap)
+		if (!bFullUpdate && bChanged)
 		{
-			const FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
-			const USplineMeshComponent* SplineMesh = Cast<USplineMeshComponent>(MeshInitData.MeshComponentsArray[Index].Get());
-			UArrowComponent* Arrow = MeshInitData.ArrowSplineUpIndicatorArray[Index].Get();
-
-			if (MeshInitData.UpVectorInfo.bShowUpDirection
-				&& SplineMesh != nullptr
-				&& Arrow != nullptr
-				&& MeshDataInitMap.Num() > 0
-				&& Index != PointDataArraySize - 1)
-			{
-				Arrow->SetRelativeRotation(SplineMesh->GetSplineUpDir().Rotation());
-				Arrow->SetWorldLocation(TextRenderer->GetComponentLocation() + TextRenderer->GetUpVector() * UpDirectionArrowOffset);
-				Arrow->SetArrowColor(GetColorForArrow(MeshInitIndex));
-				Arrow->ArrowSize = UpDirectionArrowSize;
-				Arrow->SetVisibility(true);
-			}
-			else if (Arrow != nullptr)
-			{
-				Arrow->SetVisibility(false);
-			}
-			MeshInitIndex++;
+			DirtyChunks[Index / DynamicMeshChunkSize] = true;
 		}
 	}
-}
 
-void AFlexSplineActor::UpdateMeshComponents()
-{
-	const int32 NumSplinePoints = SplineComponent->GetNumberOfSplinePoints();
+	TArray<int32, TMemStackAllocator<>> DirtyChunkIndices;
+	for (TConstSetBitIterator<TMemStackAllocator<>> It(DirtyChunks); It; ++It)
+	{
+		DirtyChunkIndices.Add(It.GetIndex());
+	}
 
-	// Update all meshes for the current mesh initializer
-	for (TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	// Deform changed chunks on worker threads. Each chunk has its own buffers, which are kept for the next update
+	if (!DynamicMesh.Scratch.IsValid())
 	{
-		FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
-		UClass* ConfiguredMeshType = GetMeshType(MeshInitData.MeshInfo.MeshType);
+		DynamicMesh.Scratch = MakeShared<FFlexDynamicMeshScratch, ESPMode::ThreadSafe>();
+	}
+	TArray<FFlexDynamicMeshChunkBuffers>& ChunkBuffers = DynamicMesh.Scratch->Chunks;
+	if (ChunkBuffers.Num() < DirtyChunkIndices.Num())
+	{
+		ChunkBuffers.SetNum(DirtyChunkIndices.Num());
+	}
 
-		for (int32 Index = 0; Index < NumSplinePoints; Index++)
+	const FFlexDeformSourceMesh& SourceMesh = *DynamicMesh.SourceMesh;
+	ParallelFor(DirtyChunkIndices.Num(), [&](int32 DirtyIndex)
+	{
+		const int32 FirstIndex = DirtyChunkIndices[DirtyIndex] * DynamicMeshChunkSize;
+		const int32 LastIndex = FMath::Min(FirstIndex + DynamicMeshChunkSize, NumSplinePoints);
+		FFlexDynamicMeshChunkBuffers& Buffers = ChunkBuffers[DirtyIndex];
+		Buffers.Sections.SetNum(NumMaterialSlots, false);
+		SourceMesh.DeformSegments(SegmentParams, SegmentVisibility, FirstIndex, LastIndex, bSubdivide, Buffers);
+	});
+
+	// Upload changed chunks, keep index buffers if the layout of a section has not changed
+	if (bFullUpdate)
+	{
+		MeshComp->ClearAllMeshSections();
+	}
+
+	for (int32 DirtyIndex = 0; DirtyIndex < DirtyChunkIndices.Num(); DirtyIndex++)
+	{
+		for (int32 Slot = 0; Slot < NumMaterialSlots; Slot++)
 		{
-			UStaticMeshComponent* MeshComp = MeshInitData.MeshComponentsArray[Index].Get();
-			UClass* MeshType = MeshComp->GetClass();
+			const int32 SectionIndex = DirtyChunkIndices[DirtyIndex] * NumMaterialSlots + Slot;
+			const FFlexDynamicMeshSection& Section = ChunkBuffers[DirtyIndex].Sections[Slot];
+			const FProcMeshSection* ExistingSection = MeshComp->GetProcMeshSection(SectionIndex);
 
-			// Replace mesh if type has changed
-			if (ConfiguredMeshType != MeshType)
+			if (Section.Vertices.Num() == 0)
 			{
-				DestroyMeshComponent(MeshInitData, Index);
-				CreateMeshComponent(ConfiguredMeshType, MeshInitData, Index);
-				MeshComp = MeshInitData.MeshComponentsArray[Index].Get();
-				MeshType = MeshComp->GetClass();
+				MeshComp->ClearMeshSection(SectionIndex);
 			}
-
-			// Update mesh settings
-			const int32 FinalIndex = NumSplinePoints - 1;
-
-			if (!TEST_BIT(MeshInitData.GeneralInfo, EFlexGeneralFlags::Active) // Inactive
-				|| Index == FinalIndex && !GetCanLoop(MeshInitData) // No loop, so cut out last mesh 
-				|| !CanRenderFromSpawnChance(MeshInitData, Index) // Spawn chance too low
-				|| !CanRenderFromMode(MeshInitData, Index, FinalIndex)) // Render-Mode check
+			else if (ExistingSection != nullptr && ExistingSection->ProcVertexBuffer.Num() == Section.Vertices.Num())
 			{
-				MeshComp->SetVisibility(false);
-				MeshComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+				MeshComp->UpdateMeshSection(SectionIndex, Section.Vertices, Section.Normals, Section.UVs, TArray<FColor>(), Section.Tangents);
 			}
 			else
 			{
-				// Update type agnostic mesh settings
-				MeshComp->SetCollisionProfileName(MeshInitData.PhysicsInfo.CollisionProfileName);
-				MeshComp->SetVisibility(true);
-				MeshComp->SetCollisionEnabled(GetCollisionEnabled(MeshInitData));
-				MeshComp->SetGenerateOverlapEvents(MeshInitData.PhysicsInfo.bGenerateOverlapEvent);
-				MeshComp->SetMobility(EComponentMobility::Movable); // <- Required for SetStaticMesh to work correctly
-				MeshComp->SetStaticMesh(MeshInitData.MeshInfo.Mesh);
-				MeshComp->SetMobility(EComponentMobility::Static);
-				MeshComp->SetMaterial(0, MeshInitData.MeshInfo.MeshMaterial);
-
-				// Update type dependent mesh settings
-				if (MeshType == SplineMeshClass)
-				{
-					USplineMeshComponent* SplineMeshComp = Cast<USplineMeshComponent>(MeshComp);
-					UpdateSplineMesh(MeshInitData, SplineMeshComp, Index);
-				}
-				else if (MeshType == StaticMeshClass)
-				{
-					UpdateStaticMesh(MeshInitData, MeshComp, Index);
-				}
+				MeshComp->CreateMeshSection(SectionIndex, Section.Vertices, Section.Triangles, Section.Normals, Section.UVs,
+											TArray<FColor>(), Section.Tangents, bCreateCollision);
 			}
 		}
 	}
-}
 
-void AFlexSplineActor::UpdateSplineMesh(const FSplineMeshInitData& MeshInitData, USplineMeshComponent* SplineMesh, int32 CurrentIndex)
-{
-	if (SplineMesh != nullptr)
+	// Drop sections of chunks that no longer exist. Cleared sections stay in the component, clearing them again would rebuild its collision
+	for (int32 SectionIndex = NumChunks * NumMaterialSlots; SectionIndex < MeshComp->GetNumSections(); SectionIndex++)
 	{
-		const FName LayerName = GetLayerName(MeshInitData);
-		const FSplinePointData& PointData = PointDataArray[CurrentIndex];
-		const bool bSync = GetCanSynchronize(PointData) && CurrentIndex > 0;
-		auto&& PreviousPointData = bSync ? PointDataArray[CurrentIndex - 1] : FSplinePointData();
-
-		const FVector RandScale = 
-			MeshInitData.ScaleInfo.bUseUniformScaleRandomOffset
-			? FVector(RandomizeFloat(MeshInitData.ScaleInfo.UniformScaleRandomOffset, CurrentIndex, LayerName))
-			: RandomizeVector(MeshInitData.ScaleInfo.ScaleRandomOffset, CurrentIndex, LayerName);
-		const FVector2D RandScale2D = FVector2D(RandScale.Y, RandScale.Z);
-		const FVector MeshInitScale = 
-			MeshInitData.ScaleInfo.bUseUniformScale
-			? FVector(1.f, MeshInitData.ScaleInfo.UniformScale, MeshInitData.ScaleInfo.UniformScale)
-			: MeshInitData.ScaleInfo.Scale;
-		const FVector2D MeshInitScale2D = FVector2D(MeshInitScale.Y, MeshInitScale.Z) + RandScale2D;
-		const FRotator RandRotator = RandomizeRotator(MeshInitData.RotationInfo.RotationRandomOffset, CurrentIndex, LayerName);
+		if (MeshComp->GetProcMeshSection(SectionIndex)->ProcVertexBuffer.Num() > 0)
+		{
+			MeshComp->ClearMeshSection(SectionIndex);
+		}
+	}
 
-		// Set spline params
-		SetSplineMeshLocation(MeshInitData, SplineMesh, CurrentIndex);
-		SplineMesh->SetSplineUpDir(CalculateUpDirection(MeshInitData, PointData, CurrentIndex), false);
-		SplineMesh->SetForwardAxis(ToSplineAxis(MeshInitData.MeshInfo.MeshForwardAxis), false);
-		SplineMesh->SetRelativeRotation(MeshInitData.RotationInfo.Rotation + RandRotator);
-		SplineMesh->SetRelativeScale3D(FVector(MeshInitScale.X + RandScale.X, SplineMesh->GetRelativeScale3D().Y, SplineMesh->GetRelativeScale3D().Z));
-
-		// Apply spline point data (or sync with previous point if demanded)
-		SplineMesh->SetStartRoll(bSync ? PreviousPointData.EndRoll : PointData.StartRoll, false);
-		SplineMesh->SetEndRoll(PointData.EndRoll, false);
-		SplineMesh->SetStartScale((bSync ? PreviousPointData.EndScale : PointData.StartScale) * MeshInitScale2D, false);
-		SplineMesh->SetEndScale(PointData.EndScale * MeshInitScale2D, false);
-		SplineMesh->UpdateMesh();
+	// Materials can be swapped without touching the geometry
+	for (int32 SectionIndex = 0; SectionIndex < NumChunks * NumMaterialSlots; SectionIndex++)
+	{
+		const int32 Slot = SectionIndex % NumMaterialSlots;
+		UMaterialInterface* Material = Slot == 0 && MeshInitData.MeshInfo.MeshMaterial != nullptr
+			? MeshInitData.MeshInfo.MeshMaterial
+			: Mesh->GetMaterial(Slot);
+		MeshComp->SetMaterial(SectionIndex, Material);
 	}
+
+	// Full uploads are rare, keeping buffers for every chunk of the layer would keep a second copy of its geometry
+	if (bFullUpdate)
+	{
+		DynamicMesh.Scratch.Reset();
+	}
+
+	DynamicMesh.bHasCollision = bCreateCollision;
+	DynamicMesh.bSubdivided = bSubdivide;
 }
 
-void AFlexSplineActor::UpdateStaticMesh(const FSplineMeshInitData& MeshInitData, UStaticMeshComponent* StaticMesh, int32 CurrentIndex)
+void AFlexSplineActor::UpdateBakedMesh(FSplineMeshInitData& MeshInitData)
 {
-	if (StaticMesh != nullptr)
+	// One component per baked mesh
+	TArray<FStaticMeshWeakPtr>& BakedComponents = MeshInitData.BakedMeshComponentsArray;
+	while (BakedComponents.Num() > MeshInitData.BakedMeshes.Num())
+	{
+		ComponentPool.Release(BakedComponents.Pop().Get());
+	}
+	while (BakedComponents.Num() < MeshInitData.BakedMeshes.Num())
+	{
+		BakedComponents.Add(ComponentPool.Rent<UStaticMeshComponent>(this, RootComponent));
+	}
+
+	// Baked meshes already contain layer transforms and materials
+	const bool bActive = TEST_BIT(MeshInitData.GeneralInfo, EFlexGeneralFlags::Active);
+	for (int32 Index = 0; Index < BakedComponents.Num(); Index++)
 	{
-		const FSplinePointData& PointData = PointDataArray[CurrentIndex];
+		UStaticMeshComponent* MeshComp = BakedComponents[Index].Get();
+		if (MeshComp == nullptr)
+		{
+			continue;
+		}
 
-		// Apply mesh-init configurations
-		StaticMesh->SetRelativeLocation(CalculateLocation(MeshInitData, PointData, CurrentIndex));
-		StaticMesh->SetRelativeRotation(CalculateRotation(MeshInitData, PointData, CurrentIndex));
-		StaticMesh->SetRelativeScale3D(CalculateScale(MeshInitData, PointData, CurrentIndex));
+		if (MeshComp->GetCollisionProfileName() != MeshInitData.PhysicsInfo.CollisionProfileName)
+		{
+			MeshComp->SetCollisionProfileName(MeshInitData.PhysicsInfo.CollisionProfileName);
+		}
+		MeshComp->SetVisibility(bActive);
+		MeshComp->SetCollisionEnabled(bActive ? GetCollisionEnabled(MeshInitData) : ECollisionEnabled::NoCollision);
+		MeshComp->SetGenerateOverlapEvents(MeshInitData.PhysicsInfo.bGenerateOverlapEvent);
+
+		// Toggling the mobility recreates the render state, so it is only done to swap the mesh
+		if (MeshComp->GetStaticMesh() != MeshInitData.BakedMeshes[Index])
+		{
+			MeshComp->SetMobility(EComponentMobility::Movable); // <- Required for SetStaticMesh to work correctly
+			MeshComp->SetStaticMesh(MeshInitData.BakedMeshes[Index]);
+			MeshComp->SetMobility(EComponentMobility::Static);
+		}
 	}
 }
 
-FName AFlexSplineActor::GetLayerName(const FSplineMeshInitData& MeshInitData) const
+bool AFlexSplineActor::IsPointDirty(int32 Index) const
 {
-	const FName* Result = MeshDataInitMap.FindKey(MeshInitData);
-	return Result ? *Result : TEXT("");
+	return bFullRebuild || DirtyPoints[Index];
 }
 
 //////////////////////////////////////////////////////////////////////////
-// HELPERS
-void AFlexSplineActor::GetDeletedIndices(TArray<int32>& OutIndexArray) const
+// BAKING
+void AFlexSplineActor::BakeSplineMeshLayers()
 {
-	OutIndexArray.Empty();
-	const int32 PointDataArraySize = PointDataArray.Num();
-	const int32 NumberOfSplinePoints = SplineComponent->GetNumberOfSplinePoints();
+#if WITH_EDITOR
+	// Spline meshes need to be up to date before their parameters can be gathered
+	ClearBakedSplineMeshLayers();
 
-	if (PointDataArraySize > NumberOfSplinePoints)
+	const float CellSize = FMath::Max(BakeCellSize, 1.f);
+
+	for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
 	{
-		// Move along a spline-point-data-pair and store all indices that do not match(CHECK FRONT)
-		int32 DataCounter = 0;
-		int32 SplinePointCounter = 0;
-		for (; SplinePointCounter < NumberOfSplinePoints; SplinePointCounter++, DataCounter++)
+		const FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
+		if (MeshInitData.MeshInfo.MeshType != EFlexSplineMeshType::SplineMesh)
+		{
+			continue;
+		}
+
+		TSharedRef<FFlexDeformSourceMesh, ESPMode::ThreadSafe> SourceMesh = MakeShared<FFlexDeformSourceMesh, ESPMode::ThreadSafe>();
+		if (!SourceMesh->Initialize(MeshInitData.MeshInfo.Mesh))
+		{
+			UE_LOG(FlexLog, Warning, TEXT("Mesh Layer %s can not be baked, its mesh has no render data"), *MeshInitDataPair.Key.ToString());
+			continue;
+		}
+
+		// Sort all visible segments into spatial cells, subdivided segments piece by piece
+		TMap<FIntVector, TArray<FFlexSplineMeshParams>> Cells;
+		TArray<FFlexSplineMeshParams> SubSegments;
+		for (TConstSetBitIterator<> It(MeshInitData.PlacementMask); It; ++It)
 		{
-			uint32 DataID = PointDataArray[DataCounter].ID;
-			const uint32 PointID = GeneratePointHashValue(SplineComponent, SplinePointCounter);
+			const FFlexSplineMeshParams Params = CalculateSplineMeshParams(MeshInitData, It.GetIndex());
+			if (MeshInitData.MeshInfo.bSubdivideSegments)
+			{
+				SourceMesh->Subdivide(Params, SubSegments);
+			}
+			else
+			{
+				SubSegments.Reset();
+				SubSegments.Add(Params);
+			}
 
-			while (DataID != PointID)
+			for (const FFlexSplineMeshParams& SubSegment : SubSegments)
 			{
-				OutIndexArray.AddUnique(DataCounter);
-				DataCounter++;
-				DataID = PointDataArray[DataCounter].ID;
+				const FVector CellLocation = (SubSegment.StartLocation + SubSegment.EndLocation) * 0.5f / CellSize;
+				const FIntVector Cell(FMath::FloorToInt(CellLocation.X), FMath::FloorToInt(CellLocation.Y), FMath::FloorToInt(CellLocation.Z));
+				Cells.FindOrAdd(Cell).Add(SubSegment);
 			}
 		}
 
-		// Store all indices from deleted spline points at the end of the spline(CHECK BACK)
-		const int32 LastSplineIndex = NumberOfSplinePoints + OutIndexArray.Num() - 1;
-		const int32 LastDataIndex = PointDataArray.Num() - 1;
-		for (DataCounter = LastDataIndex; DataCounter > LastSplineIndex; DataCounter--)
+		if (Cells.Num() == 0)
+		{
+			continue;
+		}
+
+		// Merged meshes use the materials of the source mesh, including the layer's material override
+		TArray<FStaticMaterial> Materials = MeshInitData.MeshInfo.Mesh->StaticMaterials;
+		if (MeshInitData.MeshInfo.MeshMaterial != nullptr && Materials.Num() > 0)
 		{
-			OutIndexArray.AddUnique(DataCounter);
+			Materials[0].MaterialInterface = MeshInitData.MeshInfo.MeshMaterial;
 		}
-		// Put highest values on top, so highest indices are deleted first to avoid out-of-range-exception
-		OutIndexArray.Sort();
-		Algo::Reverse(OutIndexArray);
+
+		TArray<TArray<FFlexSplineMeshParams>> CellSegments;
+		Cells.GenerateValueArray(CellSegments);
+
+		// Only deforming and merging runs on worker threads. Static meshes are created and built synchronously on the
+		// game thread afterwards, which is the expensive part of baking and blocks the editor until all cells are built
+		const TWeakObjectPtr<AFlexSplineActor> WeakThis(this);
+		const FName LayerName = MeshInitDataPair.Key;
+		Async(EAsyncExecution::ThreadPool, [WeakThis, LayerName, SourceMesh, Materials, CellSegments = MoveTemp(CellSegments)]()
+		{
+			TArray<FMeshDescription> MeshDescriptions;
+			MeshDescriptions.SetNum(CellSegments.Num());
+			ParallelFor(CellSegments.Num(), [&](int32 CellIndex)
+			{
+				MeshDescriptions[CellIndex] = FFlexMeshBaker::BuildMergedMeshDescription(*SourceMesh, CellSegments[CellIndex], Materials);
+			});
+
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, LayerName, Materials, MeshDescriptions = MoveTemp(MeshDescriptions)]() mutable
+			{
+				AFlexSplineActor* FlexSplineActor = WeakThis.Get();
+				if (FlexSplineActor != nullptr)
+				{
+					FScopedSlowTask SlowTask(MeshDescriptions.Num(), FText::Format(NSLOCTEXT("FlexSpline", "BakeLayer", "Building baked meshes of layer {0}"),
+																				  FText::FromName(LayerName)));
+					SlowTask.MakeDialog();
+
+					TArray<UStaticMesh*> BakedMeshes;
+					for (FMeshDescription& MeshDescription : MeshDescriptions)
+					{
+						SlowTask.EnterProgressFrame();
+						BakedMeshes.Add(FFlexMeshBaker::CreateStaticMesh(FlexSplineActor, MoveTemp(MeshDescription), Materials));
+					}
+					FlexSplineActor->ApplyBakedMeshes(LayerName, BakedMeshes);
+				}
+			});
+		});
+	}
+#endif
+}
+
+void AFlexSplineActor::ClearBakedSplineMeshLayers()
+{
+	Modify();
+	for (TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
+	{
+		MeshInitDataPair.Value.BakedMeshes.Empty();
+	}
+
+	// Baking changes how whole layers are rendered
+	bFullRebuildPending = true;
+	ConstructSplineMesh();
+}
+
+void AFlexSplineActor::ApplyBakedMeshes(FName LayerName, const TArray<UStaticMesh*>& NewBakedMeshes)
+{
+	// Layer might have been removed while baking
+	FSplineMeshInitData* MeshInitData = MeshDataInitMap.Find(LayerName);
+	if (MeshInitData != nullptr)
+	{
+		Modify();
+		MeshInitData->BakedMeshes = NewBakedMeshes;
+		bFullRebuildPending = true;
+		ConstructSplineMesh();
 	}
 }
 
+
+//////////////////////////////////////////////////////////////////////////
+// HELPERS
 FVector AFlexSplineActor::GetTextPosition(int32 Index) const
 {
 	// Return top of the highest bounding box from all meshes than can be found at this point
 	const int32 PointArrayMax = PointDataArray.Num() - 1;
-	const FVector SplinePointLocation = SplineComponent->GetLocationAtSplinePoint(Index, WorldSpace);
+	const FVector SplinePointLocation = SplineComponent->GetComponentTransform().TransformPosition(SplineSamples.Locations[Index]);
 	float HighestPoint = SplinePointLocation.Z;
 
 	for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : MeshDataInitMap)
@@ -575,6 +2620,11 @@ FVector AFlexSplineActor::GetTextPosition(int32 Index) const
 	return {SplinePointLocation.X, SplinePointLocation.Y, HighestPoint};
 }
 
+bool AFlexSplineActor::CanRender(const FSplineMeshInitData& MeshInitData, int32 CurrentIndex) const
+{
+	return MeshInitData.PlacementMask[CurrentIndex];
+}
+
 bool AFlexSplineActor::CanRenderFromMode(const FSplineMeshInitData& MeshInitData, int32 CurrentIndex, int32 FinalIndex) const
 {
 	bool bResult = false;
@@ -637,19 +2687,26 @@ bool AFlexSplineActor::GetCanSynchronize(const FSplinePointData& PointData) cons
 
 FVector AFlexSplineActor::CalculateLocation(const FSplineMeshInitData& MeshInitData, const FSplinePointData& PointData, const int32 Index) const
 {
-	const FVector SplinePointLocation = SplineComponent->GetLocationAtSplinePoint(Index, LocalSpace);
+	const FVector SplinePointLocation = SplineSamples.Locations[Index];
 	FVector MeshInitLocation = MeshInitData.LocationInfo.Location;
 	FVector PointDataLocationOffset = PointData.SMLocationOffset;
-	FVector RandomizedVector = RandomizeVector(MeshInitData.LocationInfo.LocationRandomOffset, Index, GetLayerName(MeshInitData));
+	FVector RandomizedVector = RandomizeLocation(MeshInitData, PointData.ID);
 
 	if (MeshInitData.LocationInfo.CoordinateSystem == EFlexCoordinateSystem::SplinePoint)
 	{
-		const FRotator CoordSystem = SplineComponent->GetDirectionAtSplinePoint(Index, LocalSpace).Rotation();
+		const FRotator CoordSystem = SplineSamples.Directions[Index].Rotation();
 		// Rotate all values around new local coordinate system
 		MeshInitLocation = CoordSystem.RotateVector(MeshInitLocation);
 		PointDataLocationOffset = CoordSystem.RotateVector(PointDataLocationOffset);
 		RandomizedVector = CoordSystem.RotateVector(RandomizedVector);
 	}
+	else if (MeshInitData.LocationInfo.CoordinateSystem == EFlexCoordinateSystem::SplineFrame)
+	{
+		const FQuat& Frame = SplineSamples.Frames[Index];
+		MeshInitLocation = Frame.RotateVector(MeshInitLocation);
+		PointDataLocationOffset = Frame.RotateVector(PointDataLocationOffset);
+		RandomizedVector = Frame.RotateVector(RandomizedVector);
+	}
 
 	return SplinePointLocation + MeshInitLocation + PointDataLocationOffset + RandomizedVector;
 }
@@ -657,23 +2714,26 @@ FVector AFlexSplineActor::CalculateLocation(const FSplineMeshInitData& MeshInitD
 FRotator AFlexSplineActor::CalculateRotation(const FSplineMeshInitData& MeshInitData, const FSplinePointData& PointData, int32 Index) const
 {
 	const FRotator MeshInitRotation = MeshInitData.RotationInfo.Rotation;
-	const FRotator RandomRotation = RandomizeRotator(MeshInitData.RotationInfo.RotationRandomOffset, Index, GetLayerName(MeshInitData));
+	const FRotator RandomRotation = RandomizeRotation(MeshInitData, PointData.ID);
 	const FRotator PointDataRotation = PointData.SMRotation;
-	const FRotator SplinePointRotation = MeshInitData.RotationInfo.CoordinateSystem == EFlexCoordinateSystem::SplinePoint
-		? SplineComponent->GetRotationAtSplinePoint(Index, LocalSpace)
-		: FRotator::ZeroRotator;
+	FRotator SplinePointRotation = FRotator::ZeroRotator;
+	if (MeshInitData.RotationInfo.CoordinateSystem == EFlexCoordinateSystem::SplinePoint)
+	{
+		SplinePointRotation = SplineSamples.Rotations[Index];
+	}
+	else if (MeshInitData.RotationInfo.CoordinateSystem == EFlexCoordinateSystem::SplineFrame)
+	{
+		SplinePointRotation = SplineSamples.Frames[Index].Rotator();
+	}
 
 	return MeshInitRotation + RandomRotation + PointDataRotation + SplinePointRotation;
 }
 
 FVector AFlexSplineActor::CalculateScale(const FSplineMeshInitData& MeshInitData, const FSplinePointData& PointData, const int32 Index) const
 {
-	const FName LayerName = GetLayerName(MeshInitData);
-	const FVector RandomScale = MeshInitData.ScaleInfo.bUseUniformScaleRandomOffset
-		? FVector(RandomizeFloat(MeshInitData.ScaleInfo.UniformScaleRandomOffset, Index, LayerName))
-		: RandomizeVector(MeshInitData.ScaleInfo.ScaleRandomOffset, Index, LayerName);
+	const FVector RandomScale = RandomizeScale(MeshInitData, PointData.ID);
 	const FVector PointDataScale = PointData.SMScale;
-	const FVector SplinePointScale = SplineComponent->GetScaleAtSplinePoint(Index);
+	const FVector SplinePointScale = SplineSamples.Scales[Index];
 	const FVector MeshInitScale = MeshInitData.ScaleInfo.bUseUniformScale
 		? FVector(MeshInitData.ScaleInfo.UniformScale)
 		: MeshInitData.ScaleInfo.Scale;
@@ -689,82 +2749,164 @@ FVector AFlexSplineActor::CalculateUpDirection(const FSplineMeshInitData& MeshIn
 	if (MeshInitData.UpVectorInfo.CoordinateSystem == EFlexCoordinateSystem::SplinePoint)
 	{
 		// Convert vectors to be local to spline point
-		const int32 NextIndex = Index + 1 < SplineComponent->GetNumberOfSplinePoints() ? Index + 1 : Index;
+		const int32 NextIndex = Index + 1 < SplineSamples.Num() ? Index + 1 : Index;
 		const int32 PreviousIndex = Index > 0 ? Index - 1 : Index;
-		const FVector NextIndexDirection = SplineComponent->GetDirectionAtSplinePoint(NextIndex, LocalSpace);
-		const FVector PrevIndexDirection = SplineComponent->GetDirectionAtSplinePoint(PreviousIndex, LocalSpace);
+		const FVector NextIndexDirection = SplineSamples.Directions[NextIndex];
+		const FVector PrevIndexDirection = SplineSamples.Directions[PreviousIndex];
 		const FRotator CoordSystem = FMath::Lerp(PrevIndexDirection, NextIndexDirection, 0.5f).Rotation();
 		MeshInitUpDir = CoordSystem.RotateVector(MeshInitUpDir);
 		PointUpDir = CoordSystem.RotateVector(PointUpDir);
 	}
+	else if (MeshInitData.UpVectorInfo.CoordinateSystem == EFlexCoordinateSystem::SplineFrame)
+	{
+		const FQuat& Frame = SplineSamples.Frames[Index];
+		MeshInitUpDir = Frame.RotateVector(MeshInitUpDir);
+		PointUpDir = Frame.RotateVector(PointUpDir);
+	}
 
 	return MeshInitUpDir + PointUpDir;
 }
 
-void AFlexSplineActor::SetSplineMeshLocation(const FSplineMeshInitData& MeshInitData, USplineMeshComponent* OutSplineMesh, int32 Index)
+FTransform AFlexSplineActor::CalculateDistanceTransform(const FSplineMeshInitData& MeshInitData, int32 MeshIndex, float InputKey) const
 {
-	if (OutSplineMesh)
+	// Same as CalculateLocation, CalculateRotation and CalculateScale with spline values at the input key, without point data.
+	// Randomized values are seeded by the mesh index instead of a point identifier
+	FVector MeshInitLocation = MeshInitData.LocationInfo.Location;
+	FVector RandomizedVector = RandomizeLocation(MeshInitData, MeshIndex);
+	if (MeshInitData.LocationInfo.CoordinateSystem == EFlexCoordinateSystem::SplinePoint)
 	{
-		const FSplinePointData& PointData = PointDataArray[Index];
-		const int32 NextIndex = (Index + 1) % SplineComponent->GetNumberOfSplinePoints(); // Need to account for looping here
-		const bool bSync = GetCanSynchronize(PointData) && Index > 0;
-		auto&& PreviousPointData = bSync ? PointDataArray[Index - 1] : FSplinePointData();
-		const FName LayerName = GetLayerName(MeshInitData);
+		const FRotator CoordSystem = SplineComponent->GetDirectionAtSplineInputKey(InputKey, LocalSpace).Rotation();
+		MeshInitLocation = CoordSystem.RotateVector(MeshInitLocation);
+		RandomizedVector = CoordSystem.RotateVector(RandomizedVector);
+	}
+	else if (MeshInitData.LocationInfo.CoordinateSystem == EFlexCoordinateSystem::SplineFrame)
+	{
+		const FQuat Frame = GetFrameAtInputKey(SplineSamples, InputKey);
+		MeshInitLocation = Frame.RotateVector(MeshInitLocation);
+		RandomizedVector = Frame.RotateVector(RandomizedVector);
+	}
+	const FVector Location = SplineComponent->GetLocationAtSplineInputKey(InputKey, LocalSpace) + MeshInitLocation + RandomizedVector;
 
-		const FVector StartTangent = SplineComponent->GetTangentAtSplinePoint(Index, LocalSpace);
-		const FVector EndTangent = SplineComponent->GetTangentAtSplinePoint(NextIndex, LocalSpace);
-		FVector StartLocation = SplineComponent->GetLocationAtSplinePoint(Index, LocalSpace);
-		FVector EndLocation = SplineComponent->GetLocationAtSplinePoint(NextIndex, LocalSpace);
-		const FVector RandomVectorCurrentIndex = RandomizeVector(MeshInitData.LocationInfo.LocationRandomOffset, Index, LayerName);
-		const FVector RandomVectorNextIndex = RandomizeVector(MeshInitData.LocationInfo.LocationRandomOffset, NextIndex, LayerName);
+	FRotator Rotation = MeshInitData.RotationInfo.Rotation + RandomizeRotation(MeshInitData, MeshIndex);
+	if (MeshInitData.RotationInfo.CoordinateSystem == EFlexCoordinateSystem::SplinePoint)
+	{
+		Rotation += SplineComponent->GetRotationAtSplineInputKey(InputKey, LocalSpace);
+	}
+	else if (MeshInitData.RotationInfo.CoordinateSystem == EFlexCoordinateSystem::SplineFrame)
+	{
+		Rotation += GetFrameAtInputKey(SplineSamples, InputKey).Rotator();
+	}
 
-		if (MeshInitData.LocationInfo.CoordinateSystem == EFlexCoordinateSystem::SplinePoint)
-		{
-			OutSplineMesh->SetRelativeLocation(FVector::ZeroVector); // Needs to be unset in this config
-			const FRotator CurrentIndexCoordSystem = SplineComponent->GetDirectionAtSplinePoint(Index, LocalSpace).Rotation();
-			const FRotator NextIndexCoordSystem = SplineComponent->GetDirectionAtSplinePoint(NextIndex, LocalSpace).Rotation();
-			const FVector RotatedMeshInitLocationCurrentIndex = CurrentIndexCoordSystem.RotateVector(MeshInitData.LocationInfo.Location);
-			const FVector RotatedMeshInitLocationNextIndex = NextIndexCoordSystem.RotateVector(MeshInitData.LocationInfo.Location);
-			StartLocation += RotatedMeshInitLocationCurrentIndex + RandomVectorCurrentIndex;
-			EndLocation += RotatedMeshInitLocationNextIndex + RandomVectorNextIndex;
-		}
-		else if (MeshInitData.LocationInfo.CoordinateSystem == EFlexCoordinateSystem::SplineSystem)
-		{
-			OutSplineMesh->SetRelativeLocation(MeshInitData.LocationInfo.Location + RandomVectorCurrentIndex);
-		}
+	const FVector MeshInitScale = MeshInitData.ScaleInfo.bUseUniformScale
+		? FVector(MeshInitData.ScaleInfo.UniformScale)
+		: MeshInitData.ScaleInfo.Scale;
+	const FVector Scale = MeshInitScale * SplineComponent->GetScaleAtSplineInputKey(InputKey) + RandomizeScale(MeshInitData, MeshIndex);
 
-		OutSplineMesh->SetStartAndEnd(StartLocation, StartTangent, EndLocation, EndTangent);
-		OutSplineMesh->SetStartOffset(bSync ? PreviousPointData.EndOffset : PointData.StartOffset);
-		OutSplineMesh->SetEndOffset(PointData.EndOffset);
-	}
+	return FTransform(Rotation, Location, Scale);
 }
 
-UStaticMeshComponent* AFlexSplineActor::CreateMeshComponent(UClass* MeshType, FSplineMeshInitData& MeshInitData, int32 Index)
+FFlexSplineMeshParams AFlexSplineActor::CalculateSplineMeshParams(const FSplineMeshInitData& MeshInitData, int32 Index) const
 {
-	UStaticMeshComponent* NewMesh = NewObject<UStaticMeshComponent>(this, MeshType);
-	NewMesh->RegisterComponent();
-	NewMesh->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
+	FFlexSplineMeshParams Params;
+	const FSplinePointData& PointData = PointDataArray[Index];
+	const bool bSync = GetCanSynchronize(PointData) && Index > 0;
+	const FSplinePointData& PreviousPointData = bSync ? PointDataArray[Index - 1] : PointData; // Only read if synchronized
+
+	const FVector RandScale = RandomizeScale(MeshInitData, PointData.ID);
+	const FVector2D RandScale2D = FVector2D(RandScale.Y, RandScale.Z);
+	const FVector MeshInitScale = 
+		MeshInitData.ScaleInfo.bUseUniformScale
+		? FVector(1.f, MeshInitData.ScaleInfo.UniformScale, MeshInitData.ScaleInfo.UniformScale)
+		: MeshInitData.ScaleInfo.Scale;
+	const FVector2D MeshInitScale2D = FVector2D(MeshInitScale.Y, MeshInitScale.Z) + RandScale2D;
+	const FRotator RandRotator = RandomizeRotation(MeshInitData, PointData.ID);
+
+	// Spline params
+	CalculateSplineMeshLocation(MeshInitData, Index, Params);
+	Params.UpDirection = CalculateUpDirection(MeshInitData, PointData, Index);
+	Params.ForwardAxis = MeshInitData.MeshInfo.MeshForwardAxis;
+	Params.RelativeRotation = MeshInitData.RotationInfo.Rotation + RandRotator;
+	Params.RelativeScaleX = MeshInitScale.X + RandScale.X;
+
+	// Spline point data (or sync with previous point if demanded)
+	Params.StartRoll = bSync ? PreviousPointData.EndRoll : PointData.StartRoll;
+	Params.EndRoll = PointData.EndRoll;
+	Params.StartScale = (bSync ? PreviousPointData.EndScale : PointData.StartScale) * MeshInitScale2D;
+	Params.EndScale = PointData.EndScale * MeshInitScale2D;
+
+	return Params;
+}
 
-	if (Index < 0)
+void AFlexSplineActor::CalculateSplineMeshLocation(const FSplineMeshInitData& MeshInitData, int32 Index, FFlexSplineMeshParams& OutParams) const
+{
+	const FSplinePointData& PointData = PointDataArray[Index];
+	const int32 NextIndex = (Index + 1) % SplineSamples.Num(); // Need to account for looping here
+	const bool bSync = GetCanSynchronize(PointData) && Index > 0;
+	const FSplinePointData& PreviousPointData = bSync ? PointDataArray[Index - 1] : PointData; // Only read if synchronized
+
+	const FVector StartTangent = SplineSamples.Tangents[Index];
+	const FVector EndTangent = SplineSamples.Tangents[NextIndex];
+	FVector StartLocation = SplineSamples.Locations[Index];
+	FVector EndLocation = SplineSamples.Locations[NextIndex];
+	const FVector RandomVectorCurrentIndex = RandomizeLocation(MeshInitData, PointData.ID);
+	const FVector RandomVectorNextIndex = RandomizeLocation(MeshInitData, PointDataArray[NextIndex].ID);
+
+	OutParams.RelativeLocation = FVector::ZeroVector; // Needs to be unset in spline point config
+	if (MeshInitData.LocationInfo.CoordinateSystem == EFlexCoordinateSystem::SplinePoint)
 	{
-		MeshInitData.MeshComponentsArray.Add(NewMesh);
+		const FRotator CurrentIndexCoordSystem = SplineSamples.Directions[Index].Rotation();
+		const FRotator NextIndexCoordSystem = SplineSamples.Directions[NextIndex].Rotation();
+		const FVector RotatedMeshInitLocationCurrentIndex = CurrentIndexCoordSystem.RotateVector(MeshInitData.LocationInfo.Location);
+		const FVector RotatedMeshInitLocationNextIndex = NextIndexCoordSystem.RotateVector(MeshInitData.LocationInfo.Location);
+		StartLocation += RotatedMeshInitLocationCurrentIndex + RandomVectorCurrentIndex;
+		EndLocation += RotatedMeshInitLocationNextIndex + RandomVectorNextIndex;
 	}
-	else
+	else if (MeshInitData.LocationInfo.CoordinateSystem == EFlexCoordinateSystem::SplineFrame)
+	{
+		StartLocation += SplineSamples.Frames[Index].RotateVector(MeshInitData.LocationInfo.Location) + RandomVectorCurrentIndex;
+		EndLocation += SplineSamples.Frames[NextIndex].RotateVector(MeshInitData.LocationInfo.Location) + RandomVectorNextIndex;
+	}
+	else if (MeshInitData.LocationInfo.CoordinateSystem == EFlexCoordinateSystem::SplineSystem)
+	{
+		OutParams.RelativeLocation = MeshInitData.LocationInfo.Location + RandomVectorCurrentIndex;
+	}
+
+	OutParams.StartLocation = StartLocation;
+	OutParams.StartTangent = StartTangent;
+	OutParams.EndLocation = EndLocation;
+	OutParams.EndTangent = EndTangent;
+	OutParams.StartOffset = bSync ? PreviousPointData.EndOffset : PointData.StartOffset;
+	OutParams.EndOffset = PointData.EndOffset;
+}
+
+UStaticMeshComponent* AFlexSplineActor::CreateMeshComponent(UClass* MeshType, FSplineMeshInitData& MeshInitData, int32 Index)
+{
+	// No mesh type means this layer does not use a component per spline point, only keep the slot
+	UStaticMeshComponent* NewMesh = nullptr;
+	if (MeshType != nullptr)
 	{
-		MeshInitData.MeshComponentsArray.Insert(NewMesh, Index);
+		NewMesh = ComponentPool.Rent<UStaticMeshComponent>(this, RootComponent, MeshType);
 	}
 
+	MeshInitData.MeshComponentsArray[Index] = NewMesh;
+	MeshInitData.AppliedMeshStates[Index] = FFlexAppliedMeshState();
 	return NewMesh;
 }
 
-UArrowComponent* AFlexSplineActor::CreateArrowComponent(FSplineMeshInitData& MeshInitData)
+UHierarchicalInstancedStaticMeshComponent* AFlexSplineActor::CreateInstancedMeshComponent(FSplineMeshInitData& MeshInitData)
+{
+	UHierarchicalInstancedStaticMeshComponent* NewInstancedMesh = ComponentPool.Rent<UHierarchicalInstancedStaticMeshComponent>(this, RootComponent);
+	NewInstancedMesh->SetMobility(EComponentMobility::Static);
+	MeshInitData.InstancedMeshComponent = NewInstancedMesh;
+
+	return NewInstancedMesh;
+}
+
+UProceduralMeshComponent* AFlexSplineActor::CreateDynamicMeshComponent(FSplineMeshInitData& MeshInitData)
 {
-	UArrowComponent* NewArrow = NewObject<UArrowComponent>(RootComponent);
-	NewArrow->RegisterComponent();
-	NewArrow->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
-	NewArrow->SetHiddenInGame(true);
-	NewArrow->ArrowSize = UpDirectionArrowSize;
-	MeshInitData.ArrowSplineUpIndicatorArray.Add(NewArrow);
+	UProceduralMeshComponent* NewDynamicMesh = ComponentPool.Rent<UProceduralMeshComponent>(this, RootComponent);
+	NewDynamicMesh->bUseAsyncCooking = true;
+	MeshInitData.DynamicMesh.Component = NewDynamicMesh;
 
-	return NewArrow;
+	return NewDynamicMesh;
 }
@@ -0,0 +1,155 @@
+#include "FlexSplineDebugComponent.h"
+
+#if WITH_EDITOR
+#include "Debug/DebugDrawService.h"
+#include "CanvasItem.h"
+#include "Engine/Canvas.h"
+#include "Engine/Engine.h"
+#include "Engine/Font.h"
+#include "SceneView.h"
+
+// Length of an arrow head on screen, in pixels
+static constexpr float ArrowHeadLength = 8.f;
+
+// Labels smaller than this on screen are not readable anyway, in pixels
+static constexpr float MinLabelHeight = 2.f;
+#endif
+
+UFlexSplineDebugComponent::UFlexSplineDebugComponent():
+	bShowLabels(false),
+	LabelColor(FColor::Cyan),
+	LabelWorldSize(100.f),
+	NumLayers(0)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	bIsEditorOnly = true;
+}
+
+#if WITH_EDITOR
+void UFlexSplineDebugComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	if (!DrawHandle.IsValid())
+	{
+		DrawHandle = UDebugDrawService::Register(TEXT("Editor"), FDebugDrawDelegate::CreateUObject(this, &UFlexSplineDebugComponent::DrawVisualization));
+	}
+}
+
+void UFlexSplineDebugComponent::OnUnregister()
+{
+	if (DrawHandle.IsValid())
+	{
+		UDebugDrawService::Unregister(DrawHandle);
+		DrawHandle.Reset();
+	}
+
+	Super::OnUnregister();
+}
+#endif
+
+void UFlexSplineDebugComponent::SetNum(int32 NumPoints, int32 InNumLayers)
+{
+	if (NumLayers != InNumLayers)
+	{
+		Arrows.Reset();
+		NumLayers = InNumLayers;
+	}
+	LabelLocations.SetNum(NumPoints);
+	Arrows.SetNum(NumPoints * NumLayers);
+
+	for (int32 Index = LabelTexts.Num(); Index < NumPoints; Index++)
+	{
+		LabelTexts.Add(FText::AsNumber(Index));
+	}
+}
+
+void UFlexSplineDebugComponent::Reset()
+{
+	LabelLocations.Empty();
+	LabelTexts.Empty();
+	Arrows.Empty();
+	NumLayers = 0;
+}
+
+void UFlexSplineDebugComponent::SetLabel(int32 PointIndex, const FVector& Location)
+{
+	LabelLocations[PointIndex] = Location;
+}
+
+void UFlexSplineDebugComponent::SetArrow(int32 PointIndex, int32 LayerIndex, const FVector& Start, const FVector& End, const FColor& Color)
+{
+	FFlexDebugArrow& Arrow = Arrows[PointIndex * NumLayers + LayerIndex];
+	Arrow.Start = Start;
+	Arrow.End = End;
+	Arrow.Color = Color;
+	Arrow.bVisible = true;
+}
+
+void UFlexSplineDebugComponent::ClearArrow(int32 PointIndex, int32 LayerIndex)
+{
+	Arrows[PointIndex * NumLayers + LayerIndex].bVisible = false;
+}
+
+#if WITH_EDITOR
+void UFlexSplineDebugComponent::DrawVisualization(UCanvas* Canvas, APlayerController* PlayerController) const
+{
+	// The service draws every registered delegate into every editor viewport, only draw into views of our own world
+	if (Canvas == nullptr
+		|| Canvas->SceneView == nullptr
+		|| Canvas->SceneView->Family->Scene == nullptr
+		|| Canvas->SceneView->Family->Scene->GetWorld() != GetWorld())
+	{
+		return;
+	}
+
+	// Projected depth is zero for locations behind the view
+	if (bShowLabels)
+	{
+		// Labels keep their world size: the font is scaled to the projected height of the label at its location
+		UFont* Font = GEngine->GetSmallFont();
+		const float FontHeight = FMath::Max(Font->GetMaxCharHeight(), 1.f);
+		const FVector LabelUp = Canvas->SceneView->GetViewUp() * LabelWorldSize;
+		FCanvasTextItem TextItem(FVector2D::ZeroVector, FText::GetEmpty(), Font, FLinearColor(LabelColor));
+		for (int32 Index = 0; Index < LabelLocations.Num(); Index++)
+		{
+			const FVector ScreenLocation = Canvas->Project(LabelLocations[Index]);
+			const FVector ScreenTop = Canvas->Project(LabelLocations[Index] + LabelUp);
+			const float LabelHeight = FVector2D::Distance(FVector2D(ScreenLocation), FVector2D(ScreenTop));
+			if (ScreenLocation.Z > 0.f && ScreenTop.Z > 0.f && LabelHeight >= MinLabelHeight)
+			{
+				const float Scale = LabelHeight / FontHeight;
+				TextItem.Position = FVector2D(ScreenLocation.X, ScreenLocation.Y - LabelHeight);
+				TextItem.Text = LabelTexts[Index];
+				TextItem.Scale = FVector2D(Scale, Scale);
+				Canvas->DrawItem(TextItem);
+			}
+		}
+	}
+
+	for (const FFlexDebugArrow& Arrow : Arrows)
+	{
+		if (!Arrow.bVisible)
+		{
+			continue;
+		}
+
+		const FVector ScreenStart = Canvas->Project(Arrow.Start);
+		const FVector ScreenEnd = Canvas->Project(Arrow.End);
+		if (ScreenStart.Z <= 0.f || ScreenEnd.Z <= 0.f)
+		{
+			continue;
+		}
+
+		const FVector2D Start(ScreenStart.X, ScreenStart.Y);
+		const FVector2D End(ScreenEnd.X, ScreenEnd.Y);
+		const FVector2D Direction = (End - Start).GetSafeNormal();
+		const FVector2D Side(-Direction.Y, Direction.X);
+		const FLinearColor Color(Arrow.Color);
+
+		Canvas->K2_DrawLine(Start, End, 1.f, Color);
+		Canvas->K2_DrawLine(End, End - (Direction - Side * 0.5f) * ArrowHeadLength, 1.f, Color);
+		Canvas->K2_DrawLine(End, End - (Direction + Side * 0.5f) * ArrowHeadLength, 1.f, Color);
+	}
+}
+#endif
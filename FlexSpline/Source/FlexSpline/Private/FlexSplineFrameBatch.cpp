@@ -0,0 +1,81 @@
+#include "FlexSplineFrameBatch.h"
+#include "HAL/IConsoleManager.h"
+
+#if !UE_BUILD_SHIPPING
+static TAutoConsoleVariable<int32> CVarFlexSplineVerifyFrames(
+	TEXT("FlexSpline.VerifyFrames"),
+	0,
+	TEXT("If set, every frame built by the batched SIMD path is compared against the scalar FRotator path.\n")
+	TEXT("Reports an ensure if any axis deviates by more than the tolerance."),
+	ECVF_Default);
+
+// Largest deviation of a frame axis from the scalar path, rotators are stored in degrees with float precision
+static constexpr float FrameTolerance = 1.e-4f;
+#endif
+
+void FFlexFrameBatch::BuildAxes()
+{
+	// Pad to full registers, so the last iteration does not read garbage
+	const int32 NumPadded = Align(Num, 4);
+	for (int32 Index = Num; Index < NumPadded; Index++)
+	{
+		Axes[0][Index] = Axes[1][Index] = Axes[2][Index] = 0.f;
+	}
+
+	// Rotation() of a direction has no roll: pitch and yaw follow from the direction itself, so
+	// sine and cosine are ratios of its components. Zero directions map to the identity like FRotator does
+	const VectorRegister Zero = VectorZero();
+	const VectorRegister One = VectorOne();
+	const VectorRegister Tiny = VectorSetFloat1(1.e-20f);
+
+	for (int32 Index = 0; Index < NumPadded; Index += 4)
+	{
+		const VectorRegister DirX = VectorLoadAligned(&Axes[0][Index]);
+		const VectorRegister DirY = VectorLoadAligned(&Axes[1][Index]);
+		const VectorRegister DirZ = VectorLoadAligned(&Axes[2][Index]);
+
+		const VectorRegister HeadingSquared = VectorMultiplyAdd(DirY, DirY, VectorMultiply(DirX, DirX));
+		const VectorRegister LengthSquared = VectorMultiplyAdd(DirZ, DirZ, HeadingSquared);
+		const VectorRegister HasHeading = VectorCompareGT(HeadingSquared, Tiny);
+		const VectorRegister HasLength = VectorCompareGT(LengthSquared, Tiny);
+		const VectorRegister InvHeading = VectorReciprocalSqrtAccurate(VectorSelect(HasHeading, HeadingSquared, One));
+		const VectorRegister InvLength = VectorReciprocalSqrtAccurate(VectorSelect(HasLength, LengthSquared, One));
+		const VectorRegister Heading = VectorMultiply(HeadingSquared, InvHeading);
+
+		const VectorRegister CosPitch = VectorSelect(HasLength, VectorMultiply(Heading, InvLength), One);
+		const VectorRegister SinPitch = VectorSelect(HasLength, VectorMultiply(DirZ, InvLength), Zero);
+		const VectorRegister CosYaw = VectorSelect(HasHeading, VectorMultiply(DirX, InvHeading), One);
+		const VectorRegister SinYaw = VectorSelect(HasHeading, VectorMultiply(DirY, InvHeading), Zero);
+
+		// Rows of FRotationMatrix without roll
+		VectorStoreAligned(VectorMultiply(CosPitch, CosYaw), &Axes[0][Index]);
+		VectorStoreAligned(VectorMultiply(CosPitch, SinYaw), &Axes[1][Index]);
+		VectorStoreAligned(SinPitch, &Axes[2][Index]);
+		VectorStoreAligned(VectorNegate(SinYaw), &Axes[3][Index]);
+		VectorStoreAligned(CosYaw, &Axes[4][Index]);
+		VectorStoreAligned(Zero, &Axes[5][Index]);
+		VectorStoreAligned(VectorNegate(VectorMultiply(SinPitch, CosYaw)), &Axes[6][Index]);
+		VectorStoreAligned(VectorNegate(VectorMultiply(SinPitch, SinYaw)), &Axes[7][Index]);
+		VectorStoreAligned(CosPitch, &Axes[8][Index]);
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+bool FFlexFrameBatch::IsVerifyEnabled()
+{
+	return CVarFlexSplineVerifyFrames.GetValueOnAnyThread() != 0;
+}
+
+void FFlexFrameBatch::Verify(int32 Index, const FVector& Direction) const
+{
+	const FRotator Rotation = Direction.Rotation();
+	const FVector UnitAxes[] = {FVector::ForwardVector, FVector::RightVector, FVector::UpVector};
+	for (const FVector& Axis : UnitAxes)
+	{
+		const FVector Expected = Rotation.RotateVector(Axis);
+		const FVector Actual = Rotate(Index, Axis);
+		ensureMsgf(Expected.Equals(Actual, FrameTolerance), TEXT("Frame of direction %s deviates from its rotator: %s instead of %s"),
+				   *Direction.ToString(), *Actual.ToString(), *Expected.ToString());
+	}
+}
+#endif
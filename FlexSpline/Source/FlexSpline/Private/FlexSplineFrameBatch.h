@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Local coordinate systems of many spline directions at once, as used to place meshes relative to a spline point.
+* Rotating a vector by frame N gives the same result as Direction.Rotation().RotateVector(Vector), up to float precision,
+* but frames are built four at a time with SIMD and without any trigonometry.
+* Axes are stored as structure of arrays: forward X, Y, Z, right X, Y, Z, up X, Y, Z
+*/
+struct FFlexFrameBatch
+{
+	static constexpr int32 MaxFrames = 64;
+
+	/** Build frames for the directions returned by @param GetDirection for 0 to @param InNum - 1 */
+	template<typename DirectionFunctorType>
+	void Build(int32 InNum, DirectionFunctorType&& GetDirection)
+	{
+		check(InNum <= MaxFrames);
+		Num = InNum;
+
+		// Directions are written to the forward axis rows, which are replaced by the frames in place
+		for (int32 Index = 0; Index < InNum; Index++)
+		{
+			const FVector Direction = GetDirection(Index);
+			Axes[0][Index] = Direction.X;
+			Axes[1][Index] = Direction.Y;
+			Axes[2][Index] = Direction.Z;
+		}
+		BuildAxes();
+
+#if !UE_BUILD_SHIPPING
+		if (IsVerifyEnabled())
+		{
+			for (int32 Index = 0; Index < InNum; Index++)
+			{
+				Verify(Index, GetDirection(Index));
+			}
+		}
+#endif
+	}
+
+	/** Rotate @param Vector into the frame at @param Index */
+	FORCEINLINE FVector Rotate(int32 Index, const FVector& Vector) const
+	{
+		return {Vector.X * Axes[0][Index] + Vector.Y * Axes[3][Index] + Vector.Z * Axes[6][Index],
+				Vector.X * Axes[1][Index] + Vector.Y * Axes[4][Index] + Vector.Z * Axes[7][Index],
+				Vector.X * Axes[2][Index] + Vector.Y * Axes[5][Index] + Vector.Z * Axes[8][Index]};
+	}
+
+	int32 Num = 0;
+
+
+private:
+
+	/** Replace the directions in the forward axis rows with complete frames, four at a time */
+	void BuildAxes();
+
+#if !UE_BUILD_SHIPPING
+	/** Is every frame compared against the scalar rotator path? */
+	static bool IsVerifyEnabled();
+
+	/** Compare the frame at @param Index against the rotator built from @param Direction */
+	void Verify(int32 Index, const FVector& Direction) const;
+#endif
+
+	MS_ALIGN(16) float Axes[9][MaxFrames] GCC_ALIGN(16);
+};
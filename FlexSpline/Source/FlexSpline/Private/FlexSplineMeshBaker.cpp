@@ -0,0 +1,118 @@
+#include "FlexSplineMeshBaker.h"
+
+#if WITH_EDITOR
+
+#include "FlexSplineMeshDeformer.h"
+#include "StaticMeshAttributes.h"
+#include "Engine/StaticMesh.h"
+#include "PhysicsEngine/BodySetup.h"
+
+FMeshDescription FFlexMeshBaker::BuildMergedMeshDescription(const FFlexDeformSourceMesh& SourceMesh,
+															const TArray<FFlexSplineMeshParams>& Segments,
+															const TArray<FStaticMaterial>& Materials)
+{
+	FMeshDescription MeshDescription;
+	FStaticMeshAttributes Attributes(MeshDescription);
+	Attributes.Register();
+
+	TVertexAttributesRef<FVector> VertexPositions = Attributes.GetVertexPositions();
+	TVertexInstanceAttributesRef<FVector> VertexNormals = Attributes.GetVertexInstanceNormals();
+	TVertexInstanceAttributesRef<FVector> VertexTangents = Attributes.GetVertexInstanceTangents();
+	TVertexInstanceAttributesRef<float> VertexBinormalSigns = Attributes.GetVertexInstanceBinormalSigns();
+	TVertexInstanceAttributesRef<FVector2D> VertexUVs = Attributes.GetVertexInstanceUVs();
+	TPolygonGroupAttributesRef<FName> MaterialSlotNames = Attributes.GetPolygonGroupMaterialSlotNames();
+
+	const int32 NumSourceVertices = SourceMesh.Positions.Num();
+	const int32 NumSourceTriangles = SourceMesh.Indices.Num() / 3;
+	MeshDescription.ReserveNewVertices(NumSourceVertices * Segments.Num());
+	MeshDescription.ReserveNewVertexInstances(NumSourceVertices * Segments.Num());
+	MeshDescription.ReserveNewPolygons(NumSourceTriangles * Segments.Num());
+
+	// One polygon group per material slot, so the merged mesh keeps the materials of the source mesh
+	TArray<FPolygonGroupID> PolygonGroups;
+	for (const FStaticMaterial& Material : Materials)
+	{
+		const FPolygonGroupID PolygonGroup = MeshDescription.CreatePolygonGroup();
+		MaterialSlotNames[PolygonGroup] = Material.MaterialSlotName;
+		PolygonGroups.Add(PolygonGroup);
+	}
+	if (PolygonGroups.Num() == 0)
+	{
+		PolygonGroups.Add(MeshDescription.CreatePolygonGroup());
+	}
+
+	FFlexDeformedVertices DeformedVertices;
+	TArray<FVertexInstanceID> SegmentVertexInstances;
+	TArray<FVertexInstanceID> TriangleVertexInstances;
+	SegmentVertexInstances.Reserve(NumSourceVertices);
+	TriangleVertexInstances.Reserve(3);
+
+	for (const FFlexSplineMeshParams& Segment : Segments)
+	{
+		SourceMesh.Deform(Segment, DeformedVertices);
+
+		// Copy vertices of this segment
+		SegmentVertexInstances.Reset();
+		for (int32 Index = 0; Index < NumSourceVertices; Index++)
+		{
+			const FVertexID VertexID = MeshDescription.CreateVertex();
+			VertexPositions[VertexID] = DeformedVertices.Positions[Index];
+
+			const FVertexInstanceID VertexInstanceID = MeshDescription.CreateVertexInstance(VertexID);
+			VertexNormals[VertexInstanceID] = DeformedVertices.Normals[Index];
+			VertexTangents[VertexInstanceID] = DeformedVertices.Tangents[Index];
+			VertexBinormalSigns[VertexInstanceID] = SourceMesh.BinormalSigns[Index];
+			VertexUVs.Set(VertexInstanceID, 0, SourceMesh.UVs[Index]);
+			SegmentVertexInstances.Add(VertexInstanceID);
+		}
+
+		// Copy triangles of this segment, sorted into the polygon group of their section
+		for (const FFlexDeformSourceMesh::FSection& Section : SourceMesh.Sections)
+		{
+			const FPolygonGroupID PolygonGroup = PolygonGroups[FMath::Clamp(Section.MaterialIndex, 0, PolygonGroups.Num() - 1)];
+			for (int32 Triangle = 0; Triangle < Section.NumTriangles; Triangle++)
+			{
+				const int32 FirstIndex = Section.FirstIndex + Triangle * 3;
+				TriangleVertexInstances.Reset();
+				TriangleVertexInstances.Add(SegmentVertexInstances[SourceMesh.Indices[FirstIndex + 0]]);
+				TriangleVertexInstances.Add(SegmentVertexInstances[SourceMesh.Indices[FirstIndex + 1]]);
+				TriangleVertexInstances.Add(SegmentVertexInstances[SourceMesh.Indices[FirstIndex + 2]]);
+				MeshDescription.CreatePolygon(PolygonGroup, TriangleVertexInstances);
+			}
+		}
+	}
+
+	return MeshDescription;
+}
+
+UStaticMesh* FFlexMeshBaker::CreateStaticMesh(UObject* Outer, FMeshDescription&& MeshDescription, const TArray<FStaticMaterial>& Materials)
+{
+	check(IsInGameThread());
+
+	UStaticMesh* StaticMesh = NewObject<UStaticMesh>(Outer, NAME_None, RF_Transactional);
+	StaticMesh->StaticMaterials = Materials;
+	StaticMesh->LightMapCoordinateIndex = 1;
+
+	// Normals and tangents are taken from the deformed source mesh
+	FStaticMeshSourceModel& SourceModel = StaticMesh->AddSourceModel();
+	SourceModel.BuildSettings.bRecomputeNormals = false;
+	SourceModel.BuildSettings.bRecomputeTangents = false;
+	SourceModel.BuildSettings.bGenerateLightmapUVs = true;
+	SourceModel.BuildSettings.SrcLightmapIndex = 0;
+	SourceModel.BuildSettings.DstLightmapIndex = 1;
+
+	StaticMesh->CreateMeshDescription(0, MoveTemp(MeshDescription));
+	StaticMesh->CommitMeshDescription(0);
+
+	// The merged geometry doubles as collision, there is no simple collision to derive from
+	StaticMesh->CreateBodySetup();
+	StaticMesh->BodySetup->CollisionTraceFlag = CTF_UseComplexAsSimple;
+
+	// Builds render data synchronously on the calling thread
+	StaticMesh->Build(true);
+	StaticMesh->PostEditChange();
+
+	return StaticMesh;
+}
+
+#endif
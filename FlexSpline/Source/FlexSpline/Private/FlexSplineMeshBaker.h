@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_EDITOR
+
+#include "MeshDescription.h"
+#include "FlexSplineStructs.h"
+
+struct FFlexDeformSourceMesh;
+struct FStaticMaterial;
+
+/**
+* Merges deformed spline mesh segments into static mesh assets, editor only
+*/
+struct FFlexMeshBaker
+{
+	/**
+	* Deform the source mesh along every segment and merge all of them into one mesh description,
+	* with one polygon group per material slot. Thread safe
+	*/
+	static FMeshDescription BuildMergedMeshDescription(const FFlexDeformSourceMesh& SourceMesh,
+													   const TArray<FFlexSplineMeshParams>& Segments,
+													   const TArray<FStaticMaterial>& Materials);
+
+	/** Create a static mesh owned by @param Outer from the given mesh description and build it synchronously. Game thread only */
+	static UStaticMesh* CreateStaticMesh(UObject* Outer, FMeshDescription&& MeshDescription, const TArray<FStaticMaterial>& Materials);
+};
+
+#endif
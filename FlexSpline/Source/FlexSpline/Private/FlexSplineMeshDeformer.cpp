@@ -0,0 +1,314 @@
+#include "FlexSplineMeshDeformer.h"
+#include "Engine/StaticMesh.h"
+#include "StaticMeshResources.h"
+
+//////////////////////////////////////////////////////////////////////////
+// STATIC HELPERS
+static FVector SplineEvalPos(const FVector& StartPos, const FVector& StartTangent, const FVector& EndPos, const FVector& EndTangent, float A)
+{
+	const float A2 = A * A;
+	const float A3 = A2 * A;
+
+	return (((2 * A3) - (3 * A2) + 1) * StartPos) + ((A3 - (2 * A2) + A) * StartTangent) + ((A3 - A2) * EndTangent) + (((-2 * A3) + (3 * A2)) * EndPos);
+}
+
+static FVector SplineEvalTangent(const FVector& StartPos, const FVector& StartTangent, const FVector& EndPos, const FVector& EndTangent, float A)
+{
+	const FVector C = (6 * StartPos) + (3 * StartTangent) + (3 * EndTangent) - (6 * EndPos);
+	const FVector D = (-6 * StartPos) - (4 * StartTangent) - (2 * EndTangent) + (6 * EndPos);
+	const FVector E = StartTangent;
+	const float A2 = A * A;
+
+	return (C * A2) + (D * A) + E;
+}
+
+static FVector SplineEvalDir(const FVector& StartPos, const FVector& StartTangent, const FVector& EndPos, const FVector& EndTangent, float A)
+{
+	return SplineEvalTangent(StartPos, StartTangent, EndPos, EndTangent, A).GetSafeNormal();
+}
+
+static FTransform GetRelativeTransform(const FFlexSplineMeshParams& Params)
+{
+	return FTransform(Params.RelativeRotation, Params.RelativeLocation, FVector(Params.RelativeScaleX, 1.f, 1.f));
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// SOURCE MESH
+bool FFlexDeformSourceMesh::Initialize(const UStaticMesh* Mesh)
+{
+	if (Mesh == nullptr || !Mesh->RenderData.IsValid() || Mesh->RenderData->LODResources.Num() == 0)
+	{
+		return false;
+	}
+
+	// Cooked builds only keep vertex data in CPU memory if the mesh allows it
+#if !WITH_EDITOR
+	if (!Mesh->bAllowCPUAccess)
+	{
+		return false;
+	}
+#endif
+
+	const FStaticMeshLODResources& LOD = Mesh->RenderData->LODResources[0];
+	const FPositionVertexBuffer& PositionBuffer = LOD.VertexBuffers.PositionVertexBuffer;
+	const FStaticMeshVertexBuffer& VertexBuffer = LOD.VertexBuffers.StaticMeshVertexBuffer;
+	const int32 NumVertices = PositionBuffer.GetNumVertices();
+	const bool bHasUVs = VertexBuffer.GetNumTexCoords() > 0;
+
+	Positions.SetNumUninitialized(NumVertices);
+	Normals.SetNumUninitialized(NumVertices);
+	Tangents.SetNumUninitialized(NumVertices);
+	BinormalSigns.SetNumUninitialized(NumVertices);
+	UVs.SetNumUninitialized(NumVertices);
+
+	for (int32 Index = 0; Index < NumVertices; Index++)
+	{
+		const FVector4 TangentZ = VertexBuffer.VertexTangentZ(Index);
+		Positions[Index] = PositionBuffer.VertexPosition(Index);
+		Normals[Index] = FVector(TangentZ);
+		Tangents[Index] = FVector(VertexBuffer.VertexTangentX(Index));
+		BinormalSigns[Index] = TangentZ.W < 0.f ? -1.f : 1.f;
+		UVs[Index] = bHasUVs ? VertexBuffer.GetVertexUV(Index, 0) : FVector2D::ZeroVector;
+	}
+
+	LOD.IndexBuffer.GetCopy(Indices);
+
+	Sections.Reset(LOD.Sections.Num());
+	for (const FStaticMeshSection& Section : LOD.Sections)
+	{
+		Sections.Add({static_cast<int32>(Section.FirstIndex), static_cast<int32>(Section.NumTriangles), Section.MaterialIndex});
+	}
+
+	Bounds = Mesh->GetBoundingBox();
+	return IsValid();
+}
+
+void FFlexDeformSourceMesh::Deform(const FFlexSplineMeshParams& Params, FFlexDeformedVertices& OutVertices) const
+{
+	const int32 NumVertices = Positions.Num();
+	const int32 ForwardAxis = static_cast<int32>(Params.ForwardAxis);
+	const FTransform RelativeTransform = GetRelativeTransform(Params);
+
+	OutVertices.Positions.SetNumUninitialized(NumVertices, false);
+	OutVertices.Normals.SetNumUninitialized(NumVertices, false);
+	OutVertices.Tangents.SetNumUninitialized(NumVertices, false);
+
+	for (int32 Index = 0; Index < NumVertices; Index++)
+	{
+		FVector Position = Positions[Index];
+		const FTransform SliceTransform = CalcSliceTransform(Params, GetAlpha(Position, ForwardAxis));
+
+		// The slice transform replaces the forward axis component of the vertex
+		Position[ForwardAxis] = 0.f;
+
+		OutVertices.Positions[Index] = RelativeTransform.TransformPosition(SliceTransform.TransformPosition(Position));
+		OutVertices.Normals[Index] = RelativeTransform.TransformVectorNoScale(SliceTransform.TransformVectorNoScale(Normals[Index]));
+		OutVertices.Tangents[Index] = RelativeTransform.TransformVectorNoScale(SliceTransform.TransformVectorNoScale(Tangents[Index]));
+	}
+}
+
+FVector FFlexDeformSourceMesh::DeformPosition(const FFlexSplineMeshParams& Params, const FVector& Position) const
+{
+	const int32 ForwardAxis = static_cast<int32>(Params.ForwardAxis);
+	const FTransform SliceTransform = CalcSliceTransform(Params, GetAlpha(Position, ForwardAxis));
+
+	FVector SlicePosition = Position;
+	SlicePosition[ForwardAxis] = 0.f;
+
+	return GetRelativeTransform(Params).TransformPosition(SliceTransform.TransformPosition(SlicePosition));
+}
+
+void FFlexDeformSourceMesh::Subdivide(const FFlexSplineMeshParams& Params, TArray<FFlexSplineMeshParams>& OutSubSegments) const
+{
+	OutSubSegments.Reset();
+
+	// Length along the segment at evenly spaced alphas, from the chords in between
+	float Lengths[SubdivisionSamples + 1];
+	Lengths[0] = 0.f;
+	FVector PreviousPos = Params.StartLocation;
+	for (int32 Sample = 1; Sample <= SubdivisionSamples; Sample++)
+	{
+		const float Alpha = static_cast<float>(Sample) / SubdivisionSamples;
+		const FVector Pos = SplineEvalPos(Params.StartLocation, Params.StartTangent, Params.EndLocation, Params.EndTangent, Alpha);
+		Lengths[Sample] = Lengths[Sample - 1] + FVector::Dist(PreviousPos, Pos);
+		PreviousPos = Pos;
+	}
+
+	// Pieces are stretched or squashed by at most half a mesh length
+	const int32 ForwardAxis = static_cast<int32>(Params.ForwardAxis);
+	const float MeshLength = Bounds.Max[ForwardAxis] - Bounds.Min[ForwardAxis];
+	const float SegmentLength = Lengths[SubdivisionSamples];
+	const int32 NumSubSegments = MeshLength > KINDA_SMALL_NUMBER
+		? FMath::Clamp(FMath::RoundToInt(SegmentLength / MeshLength), 1, MaxSubSegments)
+		: 1;
+	if (NumSubSegments == 1)
+	{
+		OutSubSegments.Add(Params);
+		return;
+	}
+
+	// Alpha at the end of each piece, so all pieces have the same length
+	float Alphas[MaxSubSegments + 1];
+	Alphas[0] = 0.f;
+	Alphas[NumSubSegments] = 1.f;
+	int32 Sample = 1;
+	for (int32 SubSegment = 1; SubSegment < NumSubSegments; SubSegment++)
+	{
+		const float Length = SegmentLength * SubSegment / NumSubSegments;
+		while (Sample < SubdivisionSamples && Lengths[Sample] < Length)
+		{
+			Sample++;
+		}
+		const float SampleLength = Lengths[Sample] - Lengths[Sample - 1];
+		const float SampleAlpha = SampleLength > KINDA_SMALL_NUMBER ? FMath::Clamp((Length - Lengths[Sample - 1]) / SampleLength, 0.f, 1.f) : 0.f;
+		Alphas[SubSegment] = (Sample - 1 + SampleAlpha) / SubdivisionSamples;
+	}
+
+	// Tangents are scaled to the alpha range of a piece, so each piece follows the segment's curve
+	OutSubSegments.Reserve(NumSubSegments);
+	for (int32 SubSegment = 0; SubSegment < NumSubSegments; SubSegment++)
+	{
+		const float StartAlpha = Alphas[SubSegment];
+		const float EndAlpha = Alphas[SubSegment + 1];
+		const float Range = EndAlpha - StartAlpha;
+
+		FFlexSplineMeshParams& SubParams = OutSubSegments.Add_GetRef(Params);
+		SubParams.StartLocation = SplineEvalPos(Params.StartLocation, Params.StartTangent, Params.EndLocation, Params.EndTangent, StartAlpha);
+		SubParams.EndLocation = SplineEvalPos(Params.StartLocation, Params.StartTangent, Params.EndLocation, Params.EndTangent, EndAlpha);
+		SubParams.StartTangent = SplineEvalTangent(Params.StartLocation, Params.StartTangent, Params.EndLocation, Params.EndTangent, StartAlpha) * Range;
+		SubParams.EndTangent = SplineEvalTangent(Params.StartLocation, Params.StartTangent, Params.EndLocation, Params.EndTangent, EndAlpha) * Range;
+		SubParams.StartScale = FMath::Lerp(Params.StartScale, Params.EndScale, StartAlpha);
+		SubParams.EndScale = FMath::Lerp(Params.StartScale, Params.EndScale, EndAlpha);
+		SubParams.StartOffset = FMath::Lerp(Params.StartOffset, Params.EndOffset, StartAlpha);
+		SubParams.EndOffset = FMath::Lerp(Params.StartOffset, Params.EndOffset, EndAlpha);
+		SubParams.StartRoll = FMath::Lerp(Params.StartRoll, Params.EndRoll, StartAlpha);
+		SubParams.EndRoll = FMath::Lerp(Params.StartRoll, Params.EndRoll, EndAlpha);
+	}
+}
+
+void FFlexDeformSourceMesh::DeformSegments(const TArray<FFlexSplineMeshParams>& SegmentParams, const TBitArray<>& SegmentVisibility,
+										   int32 FirstIndex, int32 LastIndex, bool bSubdivide, FFlexDynamicMeshChunkBuffers& Buffers) const
+{
+	for (FFlexDynamicMeshSection& Section : Buffers.Sections)
+	{
+		Section.Vertices.Reset();
+		Section.Triangles.Reset();
+		Section.Normals.Reset();
+		Section.UVs.Reset();
+		Section.Tangents.Reset();
+	}
+
+	// Entries are cleared after each section, so the table only has to be filled if the mesh has changed
+	if (Buffers.VertexRemap.Num() != Positions.Num())
+	{
+		Buffers.VertexRemap.Init(INDEX_NONE, Positions.Num());
+	}
+
+	for (int32 Index = FirstIndex; Index < LastIndex; Index++)
+	{
+		if (!SegmentVisibility[Index])
+		{
+			continue;
+		}
+
+		// Subdivided segments repeat the mesh once per piece
+		if (bSubdivide)
+		{
+			Subdivide(SegmentParams[Index], Buffers.SubSegments);
+		}
+		else
+		{
+			Buffers.SubSegments.Reset();
+			Buffers.SubSegments.Add(SegmentParams[Index]);
+		}
+
+		for (const FFlexSplineMeshParams& SubSegment : Buffers.SubSegments)
+		{
+			Deform(SubSegment, Buffers.DeformedVertices);
+
+			for (const FSection& SourceSection : Sections)
+			{
+				FFlexDynamicMeshSection& Section = Buffers.Sections[FMath::Clamp(SourceSection.MaterialIndex, 0, Buffers.Sections.Num() - 1)];
+				const int32 SourceFirstIndex = SourceSection.FirstIndex;
+				const int32 SourceLastIndex = SourceFirstIndex + SourceSection.NumTriangles * 3;
+
+				// Copy all vertices referenced by this section, remap indices to the chunk section
+				for (int32 SourceIndex = SourceFirstIndex; SourceIndex < SourceLastIndex; SourceIndex++)
+				{
+					const uint32 SourceVertex = Indices[SourceIndex];
+					int32& RemappedVertex = Buffers.VertexRemap[SourceVertex];
+					if (RemappedVertex == INDEX_NONE)
+					{
+						RemappedVertex = Section.Vertices.Add(Buffers.DeformedVertices.Positions[SourceVertex]);
+						Section.Normals.Add(Buffers.DeformedVertices.Normals[SourceVertex]);
+						Section.UVs.Add(UVs[SourceVertex]);
+						Section.Tangents.Emplace(Buffers.DeformedVertices.Tangents[SourceVertex], BinormalSigns[SourceVertex] < 0.f);
+					}
+					Section.Triangles.Add(RemappedVertex);
+				}
+
+				// Only clear the entries of this section, so the remap table is not refilled per section
+				for (int32 SourceIndex = SourceFirstIndex; SourceIndex < SourceLastIndex; SourceIndex++)
+				{
+					Buffers.VertexRemap[Indices[SourceIndex]] = INDEX_NONE;
+				}
+			}
+		}
+	}
+}
+
+FTransform FFlexDeformSourceMesh::CalcSliceTransform(const FFlexSplineMeshParams& Params, float Alpha)
+{
+	// Find the point and direction of the spline at this point along
+	FVector SplinePos = SplineEvalPos(Params.StartLocation, Params.StartTangent, Params.EndLocation, Params.EndTangent, Alpha);
+	const FVector SplineDir = SplineEvalDir(Params.StartLocation, Params.StartTangent, Params.EndLocation, Params.EndTangent, Alpha);
+
+	// Find base frenet frame
+	const FVector BaseXVec = (Params.UpDirection ^ SplineDir).GetSafeNormal();
+	const FVector BaseYVec = (SplineDir ^ BaseXVec).GetSafeNormal();
+
+	// Offset the spline by the desired amount
+	const FVector2D SliceOffset = FMath::Lerp(Params.StartOffset, Params.EndOffset, Alpha);
+	SplinePos += SliceOffset.X * BaseXVec;
+	SplinePos += SliceOffset.Y * BaseYVec;
+
+	// Apply roll to frame around spline
+	const float UseRoll = FMath::Lerp(Params.StartRoll, Params.EndRoll, Alpha);
+	const float CosAng = FMath::Cos(UseRoll);
+	const float SinAng = FMath::Sin(UseRoll);
+	const FVector XVec = (CosAng * BaseXVec) - (SinAng * BaseYVec);
+	const FVector YVec = (CosAng * BaseYVec) + (SinAng * BaseXVec);
+
+	const FVector2D UseScale = FMath::Lerp(Params.StartScale, Params.EndScale, Alpha);
+
+	// Build overall transform
+	FTransform SliceTransform;
+	switch (Params.ForwardAxis)
+	{
+		case EFlexSplineAxis::X:
+			SliceTransform = FTransform(SplineDir, XVec, YVec, SplinePos);
+			SliceTransform.SetScale3D(FVector(1.f, UseScale.X, UseScale.Y));
+			break;
+		case EFlexSplineAxis::Y:
+			SliceTransform = FTransform(YVec, SplineDir, XVec, SplinePos);
+			SliceTransform.SetScale3D(FVector(UseScale.Y, 1.f, UseScale.X));
+			break;
+		case EFlexSplineAxis::Z:
+			SliceTransform = FTransform(XVec, YVec, SplineDir, SplinePos);
+			SliceTransform.SetScale3D(FVector(UseScale.X, UseScale.Y, 1.f));
+			break;
+		default:
+			break;
+	}
+
+	return SliceTransform;
+}
+
+float FFlexDeformSourceMesh::GetAlpha(const FVector& Position, int32 ForwardAxis) const
+{
+	const float MeshMin = Bounds.Min[ForwardAxis];
+	const float MeshLength = Bounds.Max[ForwardAxis] - MeshMin;
+
+	return MeshLength > KINDA_SMALL_NUMBER ? (Position[ForwardAxis] - MeshMin) / MeshLength : 0.f;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProceduralMeshComponent.h"
+#include "FlexSplineStructs.h"
+
+/** Vertex streams of a mesh deformed along one spline segment */
+struct FFlexDeformedVertices
+{
+	TArray<FVector> Positions;
+	TArray<FVector> Normals;
+	TArray<FVector> Tangents;
+};
+
+/** Geometry of one material slot within one dynamic mesh chunk */
+struct FFlexDynamicMeshSection
+{
+	TArray<FVector> Vertices;
+	TArray<int32> Triangles;
+	TArray<FVector> Normals;
+	TArray<FVector2D> UVs;
+	TArray<FProcMeshTangent> Tangents;
+};
+
+/**
+* Buffers to deform the segments of one dynamic mesh chunk. Arrays are reset instead of freed,
+* so deforming chunks of the same size again does not allocate
+*/
+struct FFlexDynamicMeshChunkBuffers
+{
+	FFlexDeformedVertices DeformedVertices;
+	TArray<FFlexSplineMeshParams> SubSegments;
+
+	/** Section vertex of each source vertex while a section is copied, INDEX_NONE if not copied yet */
+	TArray<int32> VertexRemap;
+
+	/** One section per material slot */
+	TArray<FFlexDynamicMeshSection> Sections;
+};
+
+/** Chunk buffers of a dynamic mesh layer, one per chunk deformed by the same update */
+struct FFlexDynamicMeshScratch
+{
+	TArray<FFlexDynamicMeshChunkBuffers> Chunks;
+};
+
+/**
+* CPU copy of a static mesh's first LOD, which can be deformed along spline segments
+* exactly like a spline mesh component would deform it on the GPU
+*/
+struct FFlexDeformSourceMesh
+{
+	struct FSection
+	{
+		int32 FirstIndex;
+		int32 NumTriangles;
+		int32 MaterialIndex;
+	};
+
+	TArray<FVector> Positions;
+	TArray<FVector> Normals;
+	TArray<FVector> Tangents;
+	TArray<float> BinormalSigns;
+	TArray<FVector2D> UVs;
+	TArray<uint32> Indices;
+	TArray<FSection> Sections;
+
+	/** Mesh bounds, used to map vertices onto the spline segment */
+	FBox Bounds;
+
+	FFlexDeformSourceMesh():
+		Bounds(ForceInit)
+	{
+	}
+
+	/**
+	* Copy render data of @param Mesh. Has to be called on the game thread.
+	* Returns false if the mesh has no CPU accessible render data (see "Allow CPU Access" for cooked builds)
+	*/
+	bool Initialize(const UStaticMesh* Mesh);
+
+	bool IsValid() const { return Positions.Num() > 0; }
+
+	/** Deform all vertices along the segment described by @param Params. Thread safe */
+	void Deform(const FFlexSplineMeshParams& Params, FFlexDeformedVertices& OutVertices) const;
+
+	/** Deform a single position, e.g. for bounds or picking. Thread safe */
+	FVector DeformPosition(const FFlexSplineMeshParams& Params, const FVector& Position) const;
+
+	/**
+	* Split the segment described by @param Params into pieces of equal length, as many as meshes fit along the segment
+	* without stretching them. Pieces follow the segment's curve, roll, scale and offset. Thread safe
+	*/
+	void Subdivide(const FFlexSplineMeshParams& Params, TArray<FFlexSplineMeshParams>& OutSubSegments) const;
+
+	/**
+	* Deform all visible segments from @param FirstIndex to @param LastIndex (exclusive) and sort them into
+	* one section per material slot of @param Buffers, whose number of sections is set by the caller. Thread safe
+	*/
+	void DeformSegments(const TArray<FFlexSplineMeshParams>& SegmentParams, const TBitArray<>& SegmentVisibility,
+						int32 FirstIndex, int32 LastIndex, bool bSubdivide, FFlexDynamicMeshChunkBuffers& Buffers) const;
+
+	/** Upper limit of pieces per segment */
+	static constexpr int32 MaxSubSegments = 64;
+
+private:
+
+	/** Chords per segment used to measure its length when subdividing */
+	static constexpr int32 SubdivisionSamples = 32;
+
+	/** Same as USplineMeshComponent::CalcSliceTransformAtSplineOffset */
+	static FTransform CalcSliceTransform(const FFlexSplineMeshParams& Params, float Alpha);
+
+	/** Where along the segment (0-1) does the given position lie? */
+	float GetAlpha(const FVector& Position, int32 ForwardAxis) const;
+};
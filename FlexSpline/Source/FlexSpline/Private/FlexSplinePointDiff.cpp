@@ -0,0 +1,117 @@
+#include "FlexSplinePointDiff.h"
+
+// Hash set allocator whose elements and buckets live on the mem stack
+using FMemStackSetAllocator = TSetAllocator<TSparseArrayAllocator<TMemStackAllocator<>, TMemStackAllocator<>>, TInlineAllocator<1, TMemStackAllocator<>>>;
+
+void FFlexPointDiff::Compute(TArrayView<const uint32> OldHashes, TArrayView<const uint32> NewHashes)
+{
+	NumOld = OldHashes.Num();
+	const int32 NumNew = NewHashes.Num();
+
+	NewToOld.Init(INDEX_NONE, NumNew);
+	Deleted.Reset();
+	Inserted.Reset();
+	Moved.Reset();
+	FirstShiftedIndex = INDEX_NONE;
+
+	// Common prefix and suffix are untouched, which already covers any single edit
+	const int32 MaxCommon = FMath::Min(NumOld, NumNew);
+	int32 Prefix = 0;
+	while (Prefix < MaxCommon && OldHashes[Prefix] == NewHashes[Prefix])
+	{
+		NewToOld[Prefix] = Prefix;
+		Prefix++;
+	}
+
+	int32 Suffix = 0;
+	while (Suffix < MaxCommon - Prefix && OldHashes[NumOld - 1 - Suffix] == NewHashes[NumNew - 1 - Suffix])
+	{
+		NewToOld[NumNew - 1 - Suffix] = NumOld - 1 - Suffix;
+		Suffix++;
+	}
+
+	const int32 OldEnd = NumOld - Suffix;
+	const int32 NewEnd = NumNew - Suffix;
+	if (Prefix == OldEnd && Prefix == NewEnd)
+	{
+		return;
+	}
+
+	// Match the remaining points by location. Iterate backwards, so duplicate locations map to their first point
+	TMap<uint32, int32, FMemStackSetAllocator> OldLocations;
+	OldLocations.Reserve(OldEnd - Prefix);
+	for (int32 OldIndex = OldEnd - 1; OldIndex >= Prefix; OldIndex--)
+	{
+		OldLocations.Add(OldHashes[OldIndex], OldIndex);
+	}
+
+	TBitArray<TMemStackAllocator<>> OldMatched(false, OldEnd - Prefix);
+	int32 NumUnmatchedOld = OldEnd - Prefix;
+	int32 NumUnmatchedNew = 0;
+	for (int32 NewIndex = Prefix; NewIndex < NewEnd; NewIndex++)
+	{
+		const int32* OldIndex = OldLocations.Find(NewHashes[NewIndex]);
+		if (OldIndex != nullptr && !OldMatched[*OldIndex - Prefix])
+		{
+			OldMatched[*OldIndex - Prefix] = true;
+			NewToOld[NewIndex] = *OldIndex;
+			NumUnmatchedOld--;
+		}
+		else
+		{
+			NumUnmatchedNew++;
+		}
+	}
+
+	// Pair up unmatched points in order, they keep their identity at a new location
+	int32 NumPairs = FMath::Min(NumUnmatchedOld, NumUnmatchedNew);
+	int32 OldCursor = Prefix;
+	for (int32 NewIndex = Prefix; NewIndex < NewEnd; NewIndex++)
+	{
+		if (NewToOld[NewIndex] != INDEX_NONE)
+		{
+			continue;
+		}
+
+		if (NumPairs > 0)
+		{
+			while (OldMatched[OldCursor - Prefix])
+			{
+				OldCursor++;
+			}
+			OldMatched[OldCursor - Prefix] = true;
+			NewToOld[NewIndex] = OldCursor;
+			Moved.Add(NewIndex);
+			NumPairs--;
+		}
+		else
+		{
+			Inserted.Add(NewIndex);
+		}
+	}
+
+	for (int32 OldIndex = Prefix; OldIndex < OldEnd; OldIndex++)
+	{
+		if (!OldMatched[OldIndex - Prefix])
+		{
+			Deleted.Add(OldIndex);
+		}
+	}
+
+	// Without inserts or deletes points may still have swapped places, which shifts the first point not mapped to its own index
+	if (HasStructuralChanges())
+	{
+		FirstShiftedIndex = Prefix;
+	}
+	else
+	{
+		for (int32 NewIndex = Prefix; NewIndex < NewEnd; NewIndex++)
+		{
+			if (NewToOld[NewIndex] != NewIndex)
+			{
+				FirstShiftedIndex = NewIndex;
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/MemStack.h"
+
+/**
+* Edit script that transforms the spline points of the last construction into the current ones.
+* Points are matched by their location hash. Unmatched points are paired up as moved points,
+* whatever is left over has been inserted or deleted.
+* All arrays live on the calling thread's mem stack, so a diff must not outlive the FMemMark it is created in
+*/
+struct FFlexPointDiff
+{
+	/** Number of points at the last construction */
+	int32 NumOld = 0;
+
+	/** Previous index of each current point, INDEX_NONE for inserted points */
+	TArray<int32, TMemStackAllocator<>> NewToOld;
+
+	/** Previous indices of all deleted points */
+	TArray<int32, TMemStackAllocator<>> Deleted;
+
+	/** Current indices of all inserted points */
+	TArray<int32, TMemStackAllocator<>> Inserted;
+
+	/** Current indices of all points that kept their identity but changed location */
+	TArray<int32, TMemStackAllocator<>> Moved;
+
+	/** First current index that may have shifted, INDEX_NONE if every point kept its index */
+	int32 FirstShiftedIndex = INDEX_NONE;
+
+	/** Have points been inserted or deleted? */
+	bool HasStructuralChanges() const { return Inserted.Num() > 0 || Deleted.Num() > 0; }
+
+	/** Do per point data and components need to be remapped, i.e. is NewToOld not the identity? */
+	bool IsRemapped() const { return FirstShiftedIndex != INDEX_NONE; }
+
+	/** Compute the edit script from the location hashes of the old and new points, in linear time */
+	void Compute(TArrayView<const uint32> OldHashes, TArrayView<const uint32> NewHashes);
+};
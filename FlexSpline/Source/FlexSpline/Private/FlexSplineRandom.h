@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Independent random values drawn for each layer and point */
+enum class EFlexRandomChannel : uint32
+{
+	LocationX,
+	LocationY,
+	LocationZ,
+	RotationRoll,
+	RotationPitch,
+	RotationYaw,
+	ScaleX,
+	ScaleY,
+	ScaleZ,
+	UniformScale,
+	SpawnChance
+};
+
+/**
+* Stateless, counter based random numbers. Every value is a pure function of (seed, point, channel),
+* so results are identical on any thread and in any evaluation order
+*/
+struct FFlexRandom
+{
+	/**
+	* Seed of one layer, derived from the actor's seed and the layer's name.
+	* The name string is hashed, an FName's hash depends on its name table index and changes between sessions.
+	* The string is written to the stack, seeds are derived on every construction
+	*/
+	static uint32 MakeLayerSeed(int32 ActorSeed, FName LayerName)
+	{
+		TCHAR NameString[NAME_SIZE];
+		LayerName.ToString(NameString);
+		return Mix(HashCombine(static_cast<uint32>(ActorSeed), FCrc::StrCrc32(NameString)));
+	}
+
+	static FORCEINLINE uint32 Hash(uint32 Seed, int32 PointID, EFlexRandomChannel Channel)
+	{
+		uint32 Result = Mix(Seed ^ (static_cast<uint32>(PointID) * 0x9E3779B9u));
+		return Mix(Result ^ (static_cast<uint32>(Channel) * 0x85EBCA6Bu));
+	}
+
+	/** Uniform value in [0, 1) */
+	static FORCEINLINE float Unit(uint32 Seed, int32 PointID, EFlexRandomChannel Channel)
+	{
+		// Upper 24 bits fit into a float's mantissa exactly
+		return static_cast<float>(Hash(Seed, PointID, Channel) >> 8) * (1.f / 16777216.f);
+	}
+
+	/** Uniform value in [-1, 1) */
+	static FORCEINLINE float Signed(uint32 Seed, int32 PointID, EFlexRandomChannel Channel)
+	{
+		return Unit(Seed, PointID, Channel) * 2.f - 1.f;
+	}
+
+	/** Uniform values in [0, 1) for many points at once, same results as Unit. Branch free, so the loop vectorizes */
+	static void FillUnit(uint32 Seed, TArrayView<const int32> PointIDs, EFlexRandomChannel Channel, TArrayView<float> OutValues)
+	{
+		check(PointIDs.Num() == OutValues.Num());
+		const int32 Num = PointIDs.Num();
+		const int32* RESTRICT IDs = PointIDs.GetData();
+		float* RESTRICT Values = OutValues.GetData();
+
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Values[Index] = Unit(Seed, IDs[Index], Channel);
+		}
+	}
+
+	/** Uniform values in [-1, 1) for many points at once, same results as Signed */
+	static void FillSigned(uint32 Seed, TArrayView<const int32> PointIDs, EFlexRandomChannel Channel, TArrayView<float> OutValues)
+	{
+		FillUnit(Seed, PointIDs, Channel, OutValues);
+		for (float& Value : OutValues)
+		{
+			Value = Value * 2.f - 1.f;
+		}
+	}
+
+private:
+
+	/** Murmur3 finalizer, every input bit affects every output bit */
+	static FORCEINLINE uint32 Mix(uint32 Value)
+	{
+		Value ^= Value >> 16;
+		Value *= 0x85EBCA6Bu;
+		Value ^= Value >> 13;
+		Value *= 0xC2B2AE35u;
+		Value ^= Value >> 16;
+		return Value;
+	}
+};
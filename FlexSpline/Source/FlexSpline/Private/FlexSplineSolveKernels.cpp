@@ -0,0 +1,275 @@
+#include "FlexSplineSolveKernels.h"
+
+template<EFlexGlobalConfigType SynchronizeConfig>
+static FORCEINLINE bool CanSynchronize(const FSplinePointData& PointData)
+{
+	return SynchronizeConfig == EFlexGlobalConfigType::Everywhere
+		|| (SynchronizeConfig == EFlexGlobalConfigType::Custom && PointData.bSynchroniseWithPrevious);
+}
+
+/** Rotate @param Vector into the coordinate system at @param Index, solved at @param SolveIndex of @param PointFrames */
+template<EFlexCoordinateSystem CoordinateSystem>
+static FORCEINLINE FVector RotateIntoSystem(const FFlexSplineSamples& Samples, const FFlexFrameBatch& PointFrames, int32 SolveIndex, int32 Index, const FVector& Vector)
+{
+	switch (CoordinateSystem)
+	{
+		case EFlexCoordinateSystem::SplinePoint: return PointFrames.Rotate(SolveIndex, Vector);
+		case EFlexCoordinateSystem::SplineFrame: return Samples.Frames[Index].RotateVector(Vector);
+		default: return Vector;
+	}
+}
+
+/** Same results as AFlexSplineActor::CalculateSplineMeshParams up to float precision, for a batch of points of one layer */
+template<EFlexCoordinateSystem LocationSystem, EFlexCoordinateSystem UpSystem, bool bUniformScaleRandomOffset, EFlexGlobalConfigType SynchronizeConfig>
+static void SolveSplineMeshes(const FFlexSolveContext& Context, const FFlexLayerKernel& Kernel,
+							  TArrayView<const int32> Indices, TArrayView<FFlexMeshSolveResult> OutResults)
+{
+	const FSplineMeshInitData& MeshInitData = *Kernel.MeshInitData;
+	const FFlexSplineSamples& Samples = Context.Samples;
+	const TArrayView<const FSplinePointData>& Points = Context.Points;
+	const int32 NumSamples = Samples.Num();
+	const FVector& LayerLocation = MeshInitData.LocationInfo.Location;
+	const FVector& LayerUpDirection = MeshInitData.UpVectorInfo.CustomMeshUpDirection;
+	const FRotator& LayerRotation = MeshInitData.RotationInfo.Rotation;
+	const FVector& MeshInitScale = Kernel.MeshInitScale;
+
+	// Point frames at the segment start and end and the averaged frame of the up direction, for all points of the batch at once.
+	// Rotation minimizing frames are read from the samples instead
+	FFlexFrameBatch StartFrames;
+	FFlexFrameBatch EndFrames;
+	FFlexFrameBatch UpFrames;
+	if (LocationSystem == EFlexCoordinateSystem::SplinePoint)
+	{
+		StartFrames.Build(Indices.Num(), [&](int32 SolveIndex)
+		{
+			return Samples.Directions[Indices[SolveIndex]];
+		});
+		EndFrames.Build(Indices.Num(), [&](int32 SolveIndex)
+		{
+			return Samples.Directions[(Indices[SolveIndex] + 1) % NumSamples];
+		});
+	}
+	if (UpSystem == EFlexCoordinateSystem::SplinePoint)
+	{
+		UpFrames.Build(Indices.Num(), [&](int32 SolveIndex)
+		{
+			const int32 Index = Indices[SolveIndex];
+			const FVector NextIndexDirection = Samples.Directions[Index + 1 < NumSamples ? Index + 1 : Index];
+			const FVector PrevIndexDirection = Samples.Directions[Index > 0 ? Index - 1 : Index];
+			return FMath::Lerp(PrevIndexDirection, NextIndexDirection, 0.5f);
+		});
+	}
+
+	// Random offsets of all points of the batch, and the location offsets of their segment ends
+	int32 PointIDs[FFlexLayerKernel::MaxBatchSize];
+	int32 NextPointIDs[FFlexLayerKernel::MaxBatchSize];
+	for (int32 SolveIndex = 0; SolveIndex < Indices.Num(); SolveIndex++)
+	{
+		PointIDs[SolveIndex] = Points[Indices[SolveIndex]].ID;
+		NextPointIDs[SolveIndex] = Points[(Indices[SolveIndex] + 1) % NumSamples].ID;
+	}
+	FFlexRandomBatch Random;
+	FFlexRandomBatch NextRandom;
+	Random.FillOffsets<bUniformScaleRandomOffset>(MeshInitData.LayerSeed, MakeArrayView(PointIDs, Indices.Num()));
+	if (LocationSystem != EFlexCoordinateSystem::SplineSystem)
+	{
+		NextRandom.Fill(MeshInitData.LayerSeed, MakeArrayView(NextPointIDs, Indices.Num()), EFlexRandomChannel::LocationX, EFlexRandomChannel::LocationZ);
+	}
+
+	for (int32 SolveIndex = 0; SolveIndex < Indices.Num(); SolveIndex++)
+	{
+		const int32 Index = Indices[SolveIndex];
+		FFlexMeshSolveResult& Result = OutResults[SolveIndex];
+		Result.bVisible = MeshInitData.PlacementMask[Index];
+		if (!Result.bVisible)
+		{
+			Result.Collision = ECollisionEnabled::NoCollision;
+			continue;
+		}
+		Result.Collision = Kernel.Collision;
+
+		FFlexSplineMeshParams& Params = Result.SplineParams;
+		const FSplinePointData& PointData = Points[Index];
+		const bool bSync = CanSynchronize<SynchronizeConfig>(PointData) && Index > 0;
+		const FSplinePointData& PreviousPointData = bSync ? Points[Index - 1] : PointData;
+		const int32 NextIndex = (Index + 1) % NumSamples;
+
+		// Segment
+		const FVector RandomVectorCurrentIndex = RandomizeLocation(MeshInitData, Random, SolveIndex);
+		Params.StartLocation = Samples.Locations[Index];
+		Params.EndLocation = Samples.Locations[NextIndex];
+		Params.StartTangent = Samples.Tangents[Index];
+		Params.EndTangent = Samples.Tangents[NextIndex];
+		if (LocationSystem != EFlexCoordinateSystem::SplineSystem)
+		{
+			const FVector RandomVectorNextIndex = RandomizeLocation(MeshInitData, NextRandom, SolveIndex);
+			Params.StartLocation += RotateIntoSystem<LocationSystem>(Samples, StartFrames, SolveIndex, Index, LayerLocation) + RandomVectorCurrentIndex;
+			Params.EndLocation += RotateIntoSystem<LocationSystem>(Samples, EndFrames, SolveIndex, NextIndex, LayerLocation) + RandomVectorNextIndex;
+			Params.RelativeLocation = FVector::ZeroVector;
+		}
+		else
+		{
+			Params.RelativeLocation = LayerLocation + RandomVectorCurrentIndex;
+		}
+		Params.StartOffset = bSync ? PreviousPointData.EndOffset : PointData.StartOffset;
+		Params.EndOffset = PointData.EndOffset;
+
+		// Up direction
+		Params.UpDirection = RotateIntoSystem<UpSystem>(Samples, UpFrames, SolveIndex, Index, LayerUpDirection)
+			+ RotateIntoSystem<UpSystem>(Samples, UpFrames, SolveIndex, Index, PointData.CustomPointUpDirection);
+
+		// Layer and point transform
+		const FVector RandScale = RandomizeScale<bUniformScaleRandomOffset>(MeshInitData, Random, SolveIndex);
+		const FVector2D MeshInitScale2D = FVector2D(MeshInitScale.Y, MeshInitScale.Z) + FVector2D(RandScale.Y, RandScale.Z);
+		Params.ForwardAxis = MeshInitData.MeshInfo.MeshForwardAxis;
+		Params.RelativeRotation = LayerRotation + RandomizeRotation(MeshInitData, Random, SolveIndex);
+		Params.RelativeScaleX = MeshInitScale.X + RandScale.X;
+		Params.StartRoll = bSync ? PreviousPointData.EndRoll : PointData.StartRoll;
+		Params.EndRoll = PointData.EndRoll;
+		Params.StartScale = (bSync ? PreviousPointData.EndScale : PointData.StartScale) * MeshInitScale2D;
+		Params.EndScale = PointData.EndScale * MeshInitScale2D;
+	}
+}
+
+/** Same results as the static mesh transform of AFlexSplineActor::SolveMesh up to float precision, for a batch of points of one layer */
+template<EFlexCoordinateSystem LocationSystem, EFlexCoordinateSystem RotationSystem, bool bUniformScaleRandomOffset>
+static void SolveStaticMeshes(const FFlexSolveContext& Context, const FFlexLayerKernel& Kernel,
+							  TArrayView<const int32> Indices, TArrayView<FFlexMeshSolveResult> OutResults)
+{
+	const FSplineMeshInitData& MeshInitData = *Kernel.MeshInitData;
+	const FFlexSplineSamples& Samples = Context.Samples;
+	const FVector& LayerLocation = MeshInitData.LocationInfo.Location;
+	const FRotator& LayerRotation = MeshInitData.RotationInfo.Rotation;
+	const FVector& MeshInitScale = Kernel.MeshInitScale;
+
+	FFlexFrameBatch Frames;
+	if (LocationSystem == EFlexCoordinateSystem::SplinePoint)
+	{
+		Frames.Build(Indices.Num(), [&](int32 SolveIndex)
+		{
+			return Samples.Directions[Indices[SolveIndex]];
+		});
+	}
+
+	// Random offsets of all points of the batch
+	int32 PointIDs[FFlexLayerKernel::MaxBatchSize];
+	for (int32 SolveIndex = 0; SolveIndex < Indices.Num(); SolveIndex++)
+	{
+		PointIDs[SolveIndex] = Context.Points[Indices[SolveIndex]].ID;
+	}
+	FFlexRandomBatch Random;
+	Random.FillOffsets<bUniformScaleRandomOffset>(MeshInitData.LayerSeed, MakeArrayView(PointIDs, Indices.Num()));
+
+	for (int32 SolveIndex = 0; SolveIndex < Indices.Num(); SolveIndex++)
+	{
+		const int32 Index = Indices[SolveIndex];
+		FFlexMeshSolveResult& Result = OutResults[SolveIndex];
+		Result.bVisible = MeshInitData.PlacementMask[Index];
+		if (!Result.bVisible)
+		{
+			Result.Collision = ECollisionEnabled::NoCollision;
+			continue;
+		}
+		Result.Collision = Kernel.Collision;
+
+		const FSplinePointData& PointData = Context.Points[Index];
+
+		const FVector& MeshInitLocation = LayerLocation;
+		const FVector& PointDataLocationOffset = PointData.SMLocationOffset;
+		const FVector RandomizedVector = RandomizeLocation(MeshInitData, Random, SolveIndex);
+		const FVector Location = Samples.Locations[Index]
+			+ RotateIntoSystem<LocationSystem>(Samples, Frames, SolveIndex, Index, MeshInitLocation)
+			+ RotateIntoSystem<LocationSystem>(Samples, Frames, SolveIndex, Index, PointDataLocationOffset)
+			+ RotateIntoSystem<LocationSystem>(Samples, Frames, SolveIndex, Index, RandomizedVector);
+
+		FRotator Rotation = LayerRotation + RandomizeRotation(MeshInitData, Random, SolveIndex) + PointData.SMRotation;
+		if (RotationSystem == EFlexCoordinateSystem::SplinePoint)
+		{
+			Rotation += Samples.Rotations[Index];
+		}
+		else if (RotationSystem == EFlexCoordinateSystem::SplineFrame)
+		{
+			Rotation += Samples.Frames[Index].Rotator();
+		}
+
+		const FVector Scale = MeshInitScale * Samples.Scales[Index] + PointData.SMScale
+			+ RandomizeScale<bUniformScaleRandomOffset>(MeshInitData, Random, SolveIndex);
+
+		Result.Transform = FTransform(Rotation, Location, Scale);
+	}
+}
+
+template<EFlexCoordinateSystem LocationSystem, EFlexCoordinateSystem UpSystem, bool bUniformScaleRandomOffset>
+static FFlexLayerKernel::FSolveFunction SelectSplineMeshKernel(EFlexGlobalConfigType SynchronizeConfig)
+{
+	switch (SynchronizeConfig)
+	{
+		case EFlexGlobalConfigType::Everywhere: return &SolveSplineMeshes<LocationSystem, UpSystem, bUniformScaleRandomOffset, EFlexGlobalConfigType::Everywhere>;
+		case EFlexGlobalConfigType::Custom: return &SolveSplineMeshes<LocationSystem, UpSystem, bUniformScaleRandomOffset, EFlexGlobalConfigType::Custom>;
+		default: return &SolveSplineMeshes<LocationSystem, UpSystem, bUniformScaleRandomOffset, EFlexGlobalConfigType::Nowhere>;
+	}
+}
+
+template<EFlexCoordinateSystem LocationSystem, EFlexCoordinateSystem OrientationSystem>
+static FFlexLayerKernel::FSolveFunction SelectKernel(bool bSplineMesh, bool bUniformScaleRandomOffset, EFlexGlobalConfigType SynchronizeConfig)
+{
+	if (bSplineMesh)
+	{
+		return bUniformScaleRandomOffset
+			? SelectSplineMeshKernel<LocationSystem, OrientationSystem, true>(SynchronizeConfig)
+			: SelectSplineMeshKernel<LocationSystem, OrientationSystem, false>(SynchronizeConfig);
+	}
+	return bUniformScaleRandomOffset
+		? &SolveStaticMeshes<LocationSystem, OrientationSystem, true>
+		: &SolveStaticMeshes<LocationSystem, OrientationSystem, false>;
+}
+
+/** @param OrientationSystem is the up direction's coordinate system for spline meshes and the rotation's for static meshes */
+template<EFlexCoordinateSystem LocationSystem>
+static FFlexLayerKernel::FSolveFunction SelectKernel(EFlexCoordinateSystem OrientationSystem, bool bSplineMesh, bool bUniformScaleRandomOffset, EFlexGlobalConfigType SynchronizeConfig)
+{
+	switch (OrientationSystem)
+	{
+		case EFlexCoordinateSystem::SplinePoint: return SelectKernel<LocationSystem, EFlexCoordinateSystem::SplinePoint>(bSplineMesh, bUniformScaleRandomOffset, SynchronizeConfig);
+		case EFlexCoordinateSystem::SplineFrame: return SelectKernel<LocationSystem, EFlexCoordinateSystem::SplineFrame>(bSplineMesh, bUniformScaleRandomOffset, SynchronizeConfig);
+		default: return SelectKernel<LocationSystem, EFlexCoordinateSystem::SplineSystem>(bSplineMesh, bUniformScaleRandomOffset, SynchronizeConfig);
+	}
+}
+
+FFlexLayerKernel FFlexLayerKernel::Make(const FSplineMeshInitData& InMeshInitData, ECollisionEnabled::Type InCollision, EFlexGlobalConfigType SynchronizeConfig)
+{
+	const FFlexScaleInfo& ScaleInfo = InMeshInitData.ScaleInfo;
+	const bool bSplineMesh = InMeshInitData.MeshInfo.MeshType == EFlexSplineMeshType::SplineMesh;
+	const bool bUniformScaleRandomOffset = ScaleInfo.bUseUniformScaleRandomOffset;
+	const EFlexCoordinateSystem OrientationSystem = bSplineMesh
+		? InMeshInitData.UpVectorInfo.CoordinateSystem
+		: InMeshInitData.RotationInfo.CoordinateSystem;
+
+	FFlexLayerKernel Kernel;
+	Kernel.MeshInitData = &InMeshInitData;
+	Kernel.Collision = InCollision;
+
+	switch (InMeshInitData.LocationInfo.CoordinateSystem)
+	{
+		case EFlexCoordinateSystem::SplinePoint:
+			Kernel.Solve = SelectKernel<EFlexCoordinateSystem::SplinePoint>(OrientationSystem, bSplineMesh, bUniformScaleRandomOffset, SynchronizeConfig);
+			break;
+		case EFlexCoordinateSystem::SplineFrame:
+			Kernel.Solve = SelectKernel<EFlexCoordinateSystem::SplineFrame>(OrientationSystem, bSplineMesh, bUniformScaleRandomOffset, SynchronizeConfig);
+			break;
+		default:
+			Kernel.Solve = SelectKernel<EFlexCoordinateSystem::SplineSystem>(OrientationSystem, bSplineMesh, bUniformScaleRandomOffset, SynchronizeConfig);
+			break;
+	}
+
+	// Spline meshes are stretched along the segment, so their uniform scale leaves X alone
+	if (bSplineMesh)
+	{
+		Kernel.MeshInitScale = ScaleInfo.bUseUniformScale ? FVector(1.f, ScaleInfo.UniformScale, ScaleInfo.UniformScale) : ScaleInfo.Scale;
+	}
+	else
+	{
+		Kernel.MeshInitScale = ScaleInfo.bUseUniformScale ? FVector(ScaleInfo.UniformScale) : ScaleInfo.Scale;
+	}
+	return Kernel;
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FlexSplineStructs.h"
+#include "FlexSplineRandom.h"
+#include "FlexSplineFrameBatch.h"
+
+//////////////////////////////////////////////////////////////////////////
+// RANDOM OFFSETS
+FORCEINLINE FVector RandomizeLocation(const FSplineMeshInitData& MeshInitData, int32 PointID)
+{
+	const FVector& Range = MeshInitData.LocationInfo.LocationRandomOffset;
+	const uint32 Seed = MeshInitData.LayerSeed;
+
+	return {Range.X * FFlexRandom::Signed(Seed, PointID, EFlexRandomChannel::LocationX),
+			Range.Y * FFlexRandom::Signed(Seed, PointID, EFlexRandomChannel::LocationY),
+			Range.Z * FFlexRandom::Signed(Seed, PointID, EFlexRandomChannel::LocationZ)};
+}
+
+FORCEINLINE FRotator RandomizeRotation(const FSplineMeshInitData& MeshInitData, int32 PointID)
+{
+	const FRotator& Range = MeshInitData.RotationInfo.RotationRandomOffset;
+	const uint32 Seed = MeshInitData.LayerSeed;
+
+	return {Range.Pitch * FFlexRandom::Signed(Seed, PointID, EFlexRandomChannel::RotationPitch),
+			Range.Yaw * FFlexRandom::Signed(Seed, PointID, EFlexRandomChannel::RotationYaw),
+			Range.Roll * FFlexRandom::Signed(Seed, PointID, EFlexRandomChannel::RotationRoll)};
+}
+
+template<bool bUniformScaleRandomOffset>
+FORCEINLINE FVector RandomizeScale(const FSplineMeshInitData& MeshInitData, int32 PointID)
+{
+	const FFlexScaleInfo& ScaleInfo = MeshInitData.ScaleInfo;
+	const uint32 Seed = MeshInitData.LayerSeed;
+
+	if (bUniformScaleRandomOffset)
+	{
+		return FVector(ScaleInfo.UniformScaleRandomOffset * FFlexRandom::Signed(Seed, PointID, EFlexRandomChannel::UniformScale));
+	}
+
+	return {ScaleInfo.ScaleRandomOffset.X * FFlexRandom::Signed(Seed, PointID, EFlexRandomChannel::ScaleX),
+			ScaleInfo.ScaleRandomOffset.Y * FFlexRandom::Signed(Seed, PointID, EFlexRandomChannel::ScaleY),
+			ScaleInfo.ScaleRandomOffset.Z * FFlexRandom::Signed(Seed, PointID, EFlexRandomChannel::ScaleZ)};
+}
+
+FORCEINLINE FVector RandomizeScale(const FSplineMeshInitData& MeshInitData, int32 PointID)
+{
+	return MeshInitData.ScaleInfo.bUseUniformScaleRandomOffset
+		? RandomizeScale<true>(MeshInitData, PointID)
+		: RandomizeScale<false>(MeshInitData, PointID);
+}
+
+/**
+* Signed random values of one layer for a batch of points. Filled channel by channel with FFlexRandom::FillSigned
+* before the batch is solved, so kernels read their offsets instead of hashing per point and channel
+*/
+struct FFlexRandomBatch
+{
+	static constexpr int32 MaxPoints = FFlexFrameBatch::MaxFrames;
+
+	/** Fill all channels from @param FirstChannel to @param LastChannel for the points with @param PointIDs */
+	void Fill(uint32 Seed, TArrayView<const int32> PointIDs, EFlexRandomChannel FirstChannel, EFlexRandomChannel LastChannel)
+	{
+		check(PointIDs.Num() <= MaxPoints);
+		for (uint32 Channel = static_cast<uint32>(FirstChannel); Channel <= static_cast<uint32>(LastChannel); Channel++)
+		{
+			FFlexRandom::FillSigned(Seed, PointIDs, static_cast<EFlexRandomChannel>(Channel), MakeArrayView(Values[Channel], PointIDs.Num()));
+		}
+	}
+
+	/** Fill the location, rotation and scale channels a layer's offsets are made of */
+	template<bool bUniformScaleRandomOffset>
+	void FillOffsets(uint32 Seed, TArrayView<const int32> PointIDs)
+	{
+		Fill(Seed, PointIDs, EFlexRandomChannel::LocationX, EFlexRandomChannel::RotationYaw);
+		if (bUniformScaleRandomOffset)
+		{
+			Fill(Seed, PointIDs, EFlexRandomChannel::UniformScale, EFlexRandomChannel::UniformScale);
+		}
+		else
+		{
+			Fill(Seed, PointIDs, EFlexRandomChannel::ScaleX, EFlexRandomChannel::ScaleZ);
+		}
+	}
+
+	FORCEINLINE float Get(EFlexRandomChannel Channel, int32 SolveIndex) const
+	{
+		return Values[static_cast<uint32>(Channel)][SolveIndex];
+	}
+
+private:
+
+	/** Spawn chances are rolled separately, before any point is solved */
+	static constexpr int32 NumChannels = static_cast<int32>(EFlexRandomChannel::SpawnChance);
+
+	float Values[NumChannels][MaxPoints];
+};
+
+/** Same as RandomizeLocation, read from the offsets filled for the point at @param SolveIndex */
+FORCEINLINE FVector RandomizeLocation(const FSplineMeshInitData& MeshInitData, const FFlexRandomBatch& Random, int32 SolveIndex)
+{
+	const FVector& Range = MeshInitData.LocationInfo.LocationRandomOffset;
+
+	return {Range.X * Random.Get(EFlexRandomChannel::LocationX, SolveIndex),
+			Range.Y * Random.Get(EFlexRandomChannel::LocationY, SolveIndex),
+			Range.Z * Random.Get(EFlexRandomChannel::LocationZ, SolveIndex)};
+}
+
+FORCEINLINE FRotator RandomizeRotation(const FSplineMeshInitData& MeshInitData, const FFlexRandomBatch& Random, int32 SolveIndex)
+{
+	const FRotator& Range = MeshInitData.RotationInfo.RotationRandomOffset;
+
+	return {Range.Pitch * Random.Get(EFlexRandomChannel::RotationPitch, SolveIndex),
+			Range.Yaw * Random.Get(EFlexRandomChannel::RotationYaw, SolveIndex),
+			Range.Roll * Random.Get(EFlexRandomChannel::RotationRoll, SolveIndex)};
+}
+
+template<bool bUniformScaleRandomOffset>
+FORCEINLINE FVector RandomizeScale(const FSplineMeshInitData& MeshInitData, const FFlexRandomBatch& Random, int32 SolveIndex)
+{
+	const FFlexScaleInfo& ScaleInfo = MeshInitData.ScaleInfo;
+
+	if (bUniformScaleRandomOffset)
+	{
+		return FVector(ScaleInfo.UniformScaleRandomOffset * Random.Get(EFlexRandomChannel::UniformScale, SolveIndex));
+	}
+
+	return {ScaleInfo.ScaleRandomOffset.X * Random.Get(EFlexRandomChannel::ScaleX, SolveIndex),
+			ScaleInfo.ScaleRandomOffset.Y * Random.Get(EFlexRandomChannel::ScaleY, SolveIndex),
+			ScaleInfo.ScaleRandomOffset.Z * Random.Get(EFlexRandomChannel::ScaleZ, SolveIndex)};
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// SOLVE KERNELS
+
+/** Everything a solve kernel reads besides its layer, shared by all layers of one construction */
+struct FFlexSolveContext
+{
+	const FFlexSplineSamples& Samples;
+	TArrayView<const FSplinePointData> Points;
+};
+
+/**
+* Settings of one layer resolved against the actor's global configuration, together with the solve function
+* specialized for them. Everything that is constant per layer is decided once, so the per point loop does not branch on it
+*/
+struct FFlexLayerKernel
+{
+	using FSolveFunction = void(*)(const FFlexSolveContext& Context, const FFlexLayerKernel& Kernel,
+								   TArrayView<const int32> Indices, TArrayView<FFlexMeshSolveResult> OutResults);
+
+	/** Largest number of points solved in one call, the frames of all of them are built at once */
+	static constexpr int32 MaxBatchSize = FFlexFrameBatch::MaxFrames;
+
+	const FSplineMeshInitData* MeshInitData = nullptr;
+
+	/** Collision of all visible meshes of the layer */
+	TEnumAsByte<ECollisionEnabled::Type> Collision = ECollisionEnabled::NoCollision;
+
+	/** Layer scale, uniform or per axis */
+	FVector MeshInitScale = FVector::OneVector;
+
+	/** Solve placements at @param Indices, one result per index, at most MaxBatchSize */
+	FSolveFunction Solve = nullptr;
+
+	/** Resolve the settings of @param InMeshInitData and select its kernel */
+	static FFlexLayerKernel Make(const FSplineMeshInitData& InMeshInitData, ECollisionEnabled::Type InCollision, EFlexGlobalConfigType SynchronizeConfig);
+};
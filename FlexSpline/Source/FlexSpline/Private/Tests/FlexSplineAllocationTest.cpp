@@ -0,0 +1,208 @@
+#include "Components/SplineMeshComponent.h"
+#include "FlexSplineMeshDeformer.h"
+#include "FlexSplinePointDiff.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTLS.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/FlexSplineTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+* Forwards to the allocator it replaces and counts heap calls made by the thread it was installed on.
+* Other threads keep allocating through it while it is installed, so they are forwarded but not counted
+*/
+class FFlexCountingMalloc final : public FMalloc
+{
+public:
+
+	void Install()
+	{
+		ThreadId = FPlatformTLS::GetCurrentThreadId();
+		NumAllocations = 0;
+		InnerMalloc = GMalloc;
+		GMalloc = this;
+	}
+
+	/** Returns the number of heap calls since Install */
+	int32 Uninstall()
+	{
+		GMalloc = InnerMalloc;
+		return NumAllocations;
+	}
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+	{
+		CountCall(Count);
+		return InnerMalloc->Malloc(Count, Alignment);
+	}
+
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		CountCall(Original != nullptr || Count > 0 ? 1 : 0);
+		return InnerMalloc->Realloc(Original, Count, Alignment);
+	}
+
+	virtual void Free(void* Original) override
+	{
+		CountCall(Original != nullptr ? 1 : 0);
+		InnerMalloc->Free(Original);
+	}
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+	{
+		return InnerMalloc->QuantizeSize(Count, Alignment);
+	}
+
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+	{
+		return InnerMalloc->GetAllocationSize(Original, SizeOut);
+	}
+
+	virtual bool IsInternallyThreadSafe() const override
+	{
+		return InnerMalloc->IsInternallyThreadSafe();
+	}
+
+	virtual const TCHAR* GetDescriptiveName() override
+	{
+		return TEXT("FlexSplineCountingMalloc");
+	}
+
+private:
+
+	void CountCall(SIZE_T Size)
+	{
+		if (Size > 0 && FPlatformTLS::GetCurrentThreadId() == ThreadId)
+		{
+			NumAllocations++;
+		}
+	}
+
+	FMalloc* InnerMalloc = nullptr;
+	uint32 ThreadId = 0;
+	int32 NumAllocations = 0;
+};
+
+/** Run @param Function once to warm up its buffers, then again while counting heap calls of this thread */
+template<typename FunctionType>
+static int32 CountSteadyStateAllocations(FunctionType&& Function)
+{
+	// Threads that are inside the allocator when it is uninstalled may still call it, so it is never destroyed
+	static FFlexCountingMalloc CountingMalloc;
+
+	Function();
+	CountingMalloc.Install();
+	Function();
+	return CountingMalloc.Uninstall();
+}
+
+/** Box with one material slot on its lower half and one on its upper half */
+static void MakeTestSourceMesh(FFlexDeformSourceMesh& OutMesh)
+{
+	for (int32 Corner = 0; Corner < 8; Corner++)
+	{
+		const FVector Position(Corner & 1 ? 100.f : 0.f, Corner & 2 ? 50.f : -50.f, Corner & 4 ? 50.f : -50.f);
+		OutMesh.Positions.Add(Position);
+		OutMesh.Normals.Add(Position.GetSafeNormal());
+		OutMesh.Tangents.Add(FVector::ForwardVector);
+		OutMesh.BinormalSigns.Add(1.f);
+		OutMesh.UVs.Add(FVector2D(Corner & 1, Corner & 2 ? 1.f : 0.f));
+		OutMesh.Bounds += Position;
+	}
+
+	const uint32 Faces[6][4] = {{0, 1, 3, 2}, {0, 2, 6, 4}, {0, 4, 5, 1}, {4, 6, 7, 5}, {1, 5, 7, 3}, {2, 3, 7, 6}};
+	for (const uint32* Face : Faces)
+	{
+		OutMesh.Indices.Append({Face[0], Face[1], Face[2], Face[0], Face[2], Face[3]});
+	}
+	OutMesh.Sections.Add({0, 6, 0});
+	OutMesh.Sections.Add({18, 6, 1});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlexSplineSteadyStateAllocationTest, "FlexSpline.SteadyStateAllocations",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FFlexSplineSteadyStateAllocationTest::RunTest(const FString& Parameters)
+{
+	static constexpr int32 NumSegments = 32;
+
+	// Segments along a wave of varying length, so subdivision splits them into different numbers of pieces
+	TArray<FFlexSplineMeshParams> SegmentParams;
+	TBitArray<> SegmentVisibility;
+	for (int32 Index = 0; Index < NumSegments; Index++)
+	{
+		FFlexSplineMeshParams& Params = SegmentParams.AddDefaulted_GetRef();
+		Params.StartLocation = FVector(Index * 300.f, 0.f, FMath::Sin(Index) * 100.f);
+		Params.EndLocation = FVector((Index + 1) * 300.f + (Index % 4) * 100.f, 0.f, FMath::Sin(Index + 1) * 100.f);
+		Params.StartTangent = Params.EndTangent = Params.EndLocation - Params.StartLocation;
+		SegmentVisibility.Add(Index % 5 != 0);
+	}
+
+	FFlexDeformSourceMesh SourceMesh;
+	MakeTestSourceMesh(SourceMesh);
+
+	for (const bool bSubdivide : {false, true})
+	{
+		FFlexDynamicMeshChunkBuffers Buffers;
+		Buffers.Sections.SetNum(2);
+		const int32 NumAllocations = CountSteadyStateAllocations([&]()
+		{
+			SourceMesh.DeformSegments(SegmentParams, SegmentVisibility, 0, NumSegments, bSubdivide, Buffers);
+		});
+		TestEqual(bSubdivide ? TEXT("Allocations deforming subdivided segments again") : TEXT("Allocations deforming segments again"), NumAllocations, 0);
+		TestTrue(TEXT("Both sections have geometry"), Buffers.Sections[0].Triangles.Num() > 0 && Buffers.Sections[1].Triangles.Num() > 0);
+	}
+
+	// Points moved, inserted and deleted, all bookkeeping lives on the mem stack
+	TArray<uint32> OldHashes;
+	TArray<uint32> NewHashes;
+	for (uint32 Index = 0; Index < 256; Index++)
+	{
+		OldHashes.Add(Index * 0x9E3779B9u);
+		NewHashes.Add(Index % 7 == 3 ? Index * 0x85EBCA6Bu : Index * 0x9E3779B9u);
+	}
+	NewHashes.RemoveAt(100);
+	NewHashes.Insert(0xDEADBEEFu, 200);
+
+	int32 NumMoved = 0;
+	const int32 NumAllocations = CountSteadyStateAllocations([&]()
+	{
+		FMemMark MemMark(FMemStack::Get());
+		FFlexPointDiff PointDiff;
+		PointDiff.Compute(OldHashes, NewHashes);
+		NumMoved = PointDiff.Moved.Num();
+	});
+	TestEqual(TEXT("Allocations diffing points again"), NumAllocations, 0);
+	TestTrue(TEXT("Moved points are found"), NumMoved > 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlexSplineSteadyStateConstructionTest, "FlexSpline.SteadyStateConstruction",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FFlexSplineSteadyStateConstructionTest::RunTest(const FString& Parameters)
+{
+	// Enough points for the solve phase to run on worker threads, if a construction without changes solved any of them
+	static constexpr int32 NumPoints = 80;
+
+	FFlexSplineTestWorld TestWorld(NumPoints);
+	if (!TestTrue(TEXT("Test mesh is loaded"), TestWorld.IsValid()))
+	{
+		return false;
+	}
+
+	// Spawning has constructed the actor once. One more construction without changes warms up, the one after it is counted
+	AFlexSplineActor& Actor = *TestWorld.Actor;
+	const int32 NumAllocations = CountSteadyStateAllocations([&Actor]()
+	{
+		FFlexSplineTestAccess::ConstructSplineMesh(Actor);
+	});
+	TestEqual(TEXT("Allocations constructing an unchanged actor again"), NumAllocations, 0);
+
+	TInlineComponentArray<USplineMeshComponent*> SplineMeshes(&Actor);
+	TestTrue(TEXT("Spline meshes have been placed"), SplineMeshes.Num() > 0);
+	return true;
+}
+
+#endif
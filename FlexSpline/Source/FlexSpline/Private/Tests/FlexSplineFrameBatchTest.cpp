@@ -0,0 +1,103 @@
+#include "FlexSplineFrameBatch.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlexSplineFrameBatchTest, "FlexSpline.FrameBatch",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FFlexSplineFrameBatchTest::RunTest(const FString& Parameters)
+{
+	static constexpr float Tolerance = 1.e-4f;
+
+	// Random directions of random length, followed by the cases without heading or without any length.
+	// The count is not a multiple of four, so the padded lanes of the last register are covered as well
+	FRandomStream RandomStream(0x0F1E);
+	TArray<FVector> Directions;
+	for (int32 Index = 0; Index < FFlexFrameBatch::MaxFrames - 7; Index++)
+	{
+		Directions.Add(RandomStream.GetUnitVector() * RandomStream.FRandRange(0.01f, 1000.f));
+	}
+	Directions.Add(FVector::UpVector);
+	Directions.Add(-FVector::UpVector);
+	Directions.Add(FVector::UpVector * 250.f);
+	Directions.Add(FVector::ZeroVector);
+	Directions.Add(FVector::ForwardVector);
+	Directions.Add(-FVector::ForwardVector);
+	Directions.Add(-FVector::RightVector);
+
+	FFlexFrameBatch FrameBatch;
+	FrameBatch.Build(Directions.Num(), [&Directions](int32 Index) { return Directions[Index]; });
+	TestEqual(TEXT("Number of frames"), FrameBatch.Num, Directions.Num());
+
+	const FVector TestVectors[] = {FVector::ForwardVector, FVector::RightVector, FVector::UpVector, FVector(12.f, -34.f, 56.f)};
+	for (int32 Index = 0; Index < Directions.Num(); Index++)
+	{
+		const FRotator Rotation = Directions[Index].Rotation();
+		for (const FVector& Vector : TestVectors)
+		{
+			// Compare relative to the length of the vector, so the larger test vector gets the same precision
+			const FVector Expected = Rotation.RotateVector(Vector);
+			const FVector Actual = FrameBatch.Rotate(Index, Vector);
+			TestTrue(FString::Printf(TEXT("Direction %s rotates %s to %s, expected %s"), *Directions[Index].ToString(),
+									 *Vector.ToString(), *Actual.ToString(), *Expected.ToString()),
+					 Expected.Equals(Actual, Tolerance * Vector.Size()));
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlexSplineFrameBatchBenchmark, "FlexSpline.FrameBatchBenchmark",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FFlexSplineFrameBatchBenchmark::RunTest(const FString& Parameters)
+{
+	static constexpr int32 NumPoints = 64 * 1024;
+	static constexpr int32 NumRuns = 5;
+
+	// Like a layer placing meshes at each point: one frame per direction, an offset rotated into every frame
+	FRandomStream RandomStream(0x0F1E);
+	TArray<FVector> Directions;
+	for (int32 Index = 0; Index < NumPoints; Index++)
+	{
+		Directions.Add(RandomStream.GetUnitVector() * RandomStream.FRandRange(0.01f, 1000.f));
+	}
+	const FVector Offset(12.f, -34.f, 56.f);
+
+	// Best of several runs, results are summed so neither loop can be left out
+	double RotatorSeconds = TNumericLimits<double>::Max();
+	double BatchSeconds = TNumericLimits<double>::Max();
+	FVector RotatorSum = FVector::ZeroVector;
+	FVector BatchSum = FVector::ZeroVector;
+	for (int32 Run = 0; Run < NumRuns; Run++)
+	{
+		RotatorSum = FVector::ZeroVector;
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumPoints; Index++)
+		{
+			RotatorSum += Directions[Index].Rotation().RotateVector(Offset);
+		}
+		RotatorSeconds = FMath::Min(RotatorSeconds, FPlatformTime::Seconds() - StartTime);
+
+		BatchSum = FVector::ZeroVector;
+		StartTime = FPlatformTime::Seconds();
+		FFlexFrameBatch FrameBatch;
+		for (int32 First = 0; First < NumPoints; First += FFlexFrameBatch::MaxFrames)
+		{
+			FrameBatch.Build(FMath::Min(FFlexFrameBatch::MaxFrames, NumPoints - First), [&Directions, First](int32 Index) { return Directions[First + Index]; });
+			for (int32 Index = 0; Index < FrameBatch.Num; Index++)
+			{
+				BatchSum += FrameBatch.Rotate(Index, Offset);
+			}
+		}
+		BatchSeconds = FMath::Min(BatchSeconds, FPlatformTime::Seconds() - StartTime);
+	}
+
+	AddInfo(FString::Printf(TEXT("%d points: rotator %.3f ms, frame batch %.3f ms, %.2fx faster"), NumPoints,
+							RotatorSeconds * 1000.0, BatchSeconds * 1000.0, RotatorSeconds / FMath::Max(BatchSeconds, SMALL_NUMBER)));
+	TestTrue(TEXT("Both paths rotate to the same sum"), RotatorSum.Equals(BatchSum, 1.e-4f * NumPoints * Offset.Size()));
+	return true;
+}
+
+#endif
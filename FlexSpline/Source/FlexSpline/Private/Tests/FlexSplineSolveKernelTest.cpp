@@ -0,0 +1,121 @@
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/FlexSplineTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Compare two solved placements, @param Tolerance applies to every component of every vector */
+static bool ResultsMatch(const FFlexMeshSolveResult& Kernel, const FFlexMeshSolveResult& Generic, bool bSplineMesh, float Tolerance)
+{
+	if (Kernel.bVisible != Generic.bVisible || Kernel.Collision != Generic.Collision)
+	{
+		return false;
+	}
+	if (!Kernel.bVisible)
+	{
+		return true;
+	}
+	if (!bSplineMesh)
+	{
+		return Kernel.Transform.Equals(Generic.Transform, Tolerance);
+	}
+
+	const FFlexSplineMeshParams& A = Kernel.SplineParams;
+	const FFlexSplineMeshParams& B = Generic.SplineParams;
+	return A.StartLocation.Equals(B.StartLocation, Tolerance)
+		&& A.StartTangent.Equals(B.StartTangent, Tolerance)
+		&& A.EndLocation.Equals(B.EndLocation, Tolerance)
+		&& A.EndTangent.Equals(B.EndTangent, Tolerance)
+		&& A.StartScale.Equals(B.StartScale, Tolerance)
+		&& A.EndScale.Equals(B.EndScale, Tolerance)
+		&& A.StartOffset.Equals(B.StartOffset, Tolerance)
+		&& A.EndOffset.Equals(B.EndOffset, Tolerance)
+		&& FMath::IsNearlyEqual(A.StartRoll, B.StartRoll, Tolerance)
+		&& FMath::IsNearlyEqual(A.EndRoll, B.EndRoll, Tolerance)
+		&& A.UpDirection.Equals(B.UpDirection, Tolerance)
+		&& A.ForwardAxis == B.ForwardAxis
+		&& A.RelativeLocation.Equals(B.RelativeLocation, Tolerance)
+		&& A.RelativeRotation.Equals(B.RelativeRotation, Tolerance)
+		&& FMath::IsNearlyEqual(A.RelativeScaleX, B.RelativeScaleX, Tolerance);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlexSplineSolveKernelTest, "FlexSpline.SolveKernels",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FFlexSplineSolveKernelTest::RunTest(const FString& Parameters)
+{
+	static constexpr int32 NumPoints = 1000;
+	static constexpr int32 NumRuns = 5;
+
+	// Frames are built without trigonometry, so kernels agree with the rotator path up to float precision only.
+	// Locations are thousands of units away from the origin
+	static constexpr float Tolerance = 1.e-2f;
+
+	FFlexSplineTestWorld TestWorld(NumPoints);
+	if (!TestTrue(TEXT("Test mesh is loaded"), TestWorld.IsValid()))
+	{
+		return false;
+	}
+
+	TArray<int32> Indices;
+	for (int32 Index = 0; Index < NumPoints; Index++)
+	{
+		Indices.Add(Index);
+	}
+
+	// Every layer solved per point is solved at all points, both ways. Best of several runs
+	const AFlexSplineActor& Actor = *TestWorld.Actor;
+	for (const TTuple<FName, FSplineMeshInitData>& MeshInitDataPair : FFlexSplineTestAccess::GetLayers(*TestWorld.Actor))
+	{
+		const FSplineMeshInitData& MeshInitData = MeshInitDataPair.Value;
+		if (!MeshInitData.IsSolvedPerPoint())
+		{
+			continue;
+		}
+
+		TArray<FFlexMeshSolveResult> KernelResults;
+		TArray<FFlexMeshSolveResult> GenericResults;
+		KernelResults.SetNum(NumPoints);
+		GenericResults.SetNum(NumPoints);
+
+		double KernelSeconds = TNumericLimits<double>::Max();
+		double GenericSeconds = TNumericLimits<double>::Max();
+		for (int32 Run = 0; Run < NumRuns; Run++)
+		{
+			double StartTime = FPlatformTime::Seconds();
+			FFlexSplineTestAccess::SolveWithKernel(Actor, MeshInitData, Indices, KernelResults);
+			KernelSeconds = FMath::Min(KernelSeconds, FPlatformTime::Seconds() - StartTime);
+
+			StartTime = FPlatformTime::Seconds();
+			FFlexSplineTestAccess::SolveGeneric(Actor, MeshInitData, Indices, GenericResults);
+			GenericSeconds = FMath::Min(GenericSeconds, FPlatformTime::Seconds() - StartTime);
+		}
+
+		const bool bSplineMesh = MeshInitData.MeshInfo.MeshType == EFlexSplineMeshType::SplineMesh;
+		const FString LayerName = MeshInitDataPair.Key.ToString();
+		int32 NumVisible = 0;
+		int32 NumMismatches = 0;
+		int32 FirstMismatch = INDEX_NONE;
+		for (int32 Index = 0; Index < NumPoints; Index++)
+		{
+			NumVisible += GenericResults[Index].bVisible ? 1 : 0;
+			if (!ResultsMatch(KernelResults[Index], GenericResults[Index], bSplineMesh, Tolerance))
+			{
+				FirstMismatch = FirstMismatch == INDEX_NONE ? Index : FirstMismatch;
+				NumMismatches++;
+			}
+		}
+
+		if (NumMismatches > 0)
+		{
+			AddError(FString::Printf(TEXT("Layer %s: %d of %d kernel results differ from the generic path, the first at point %d"),
+									 *LayerName, NumMismatches, NumPoints, FirstMismatch));
+		}
+		TestTrue(FString::Printf(TEXT("Layer %s renders meshes"), *LayerName), NumVisible > 0);
+		AddInfo(FString::Printf(TEXT("Layer %s, %d points: generic %.3f ms, kernel %.3f ms, %.2fx faster"), *LayerName,
+								NumPoints, GenericSeconds * 1000.0, KernelSeconds * 1000.0, GenericSeconds / FMath::Max(KernelSeconds, SMALL_NUMBER)));
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SplineComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "FlexSplineActor.h"
+#include "FlexSplineSolveKernels.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Gives automation tests access to the construction stages of an actor */
+struct FFlexSplineTestAccess
+{
+	static void ConstructSplineMesh(AFlexSplineActor& Actor)
+	{
+		Actor.ConstructSplineMesh();
+	}
+
+	static TMap<FName, FSplineMeshInitData>& GetLayers(AFlexSplineActor& Actor)
+	{
+		return Actor.MeshDataInitMap;
+	}
+
+	static USplineComponent& GetSpline(AFlexSplineActor& Actor)
+	{
+		return *Actor.SplineComponent;
+	}
+
+	/** Solve @param Indices of a layer with the kernel selected for its settings, in batches like a construction does */
+	static void SolveWithKernel(const AFlexSplineActor& Actor, const FSplineMeshInitData& MeshInitData,
+								TArrayView<const int32> Indices, TArrayView<FFlexMeshSolveResult> OutResults)
+	{
+		const FFlexLayerKernel Kernel = FFlexLayerKernel::Make(MeshInitData, Actor.GetCollisionEnabled(MeshInitData), Actor.SynchronizeConfig);
+		const FFlexSolveContext Context{Actor.SplineSamples, Actor.PointDataArray};
+		for (int32 First = 0; First < Indices.Num(); First += FFlexLayerKernel::MaxBatchSize)
+		{
+			const int32 NumBatchPoints = FMath::Min(FFlexLayerKernel::MaxBatchSize, Indices.Num() - First);
+			Kernel.Solve(Context, Kernel,
+						 MakeArrayView(Indices.GetData() + First, NumBatchPoints),
+						 MakeArrayView(OutResults.GetData() + First, NumBatchPoints));
+		}
+	}
+
+	/** Solve @param Indices of a layer one point at a time, through the generic path that evaluates all settings per point */
+	static void SolveGeneric(const AFlexSplineActor& Actor, const FSplineMeshInitData& MeshInitData,
+							 TArrayView<const int32> Indices, TArrayView<FFlexMeshSolveResult> OutResults)
+	{
+		for (int32 SolveIndex = 0; SolveIndex < Indices.Num(); SolveIndex++)
+		{
+			Actor.SolveMesh(MeshInitData, Indices[SolveIndex], OutResults[SolveIndex]);
+		}
+	}
+};
+
+/**
+* World with a single actor along a wave of spline points, destroyed along with this object.
+* Layers of all mesh types are added before the actor is spawned, so its first construction places all of them
+*/
+class FFlexSplineTestWorld
+{
+public:
+
+	FFlexSplineTestWorld(int32 NumPoints)
+	{
+		Mesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+		World = UWorld::CreateWorld(EWorldType::Game, false);
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		Actor = World->SpawnActorDeferred<AFlexSplineActor>(AFlexSplineActor::StaticClass(), FTransform::Identity);
+		USplineComponent& Spline = FFlexSplineTestAccess::GetSpline(*Actor);
+		Spline.ClearSplinePoints(false);
+		for (int32 Index = 0; Index < NumPoints; Index++)
+		{
+			Spline.AddSplinePoint(FVector(Index * 400.f, FMath::Sin(Index * 0.5f) * 300.f, FMath::Cos(Index * 0.3f) * 100.f), ESplineCoordinateSpace::Local, false);
+		}
+		Spline.UpdateSpline();
+
+		// Random offsets and spawn chances make every kernel draw random values
+		TMap<FName, FSplineMeshInitData>& Layers = FFlexSplineTestAccess::GetLayers(*Actor);
+		FSplineMeshInitData& SplineLayer = AddLayer(Layers, TEXT("Spline"), EFlexSplineMeshType::SplineMesh);
+		SplineLayer.MeshInfo.bCoalesceSegments = true;
+		SplineLayer.UpVectorInfo.CoordinateSystem = EFlexCoordinateSystem::SplineFrame;
+
+		FSplineMeshInitData& StaticLayer = AddLayer(Layers, TEXT("Static"), EFlexSplineMeshType::StaticMesh);
+		StaticLayer.LocationInfo.LocationRandomOffset = FVector(50.f, 50.f, 20.f);
+		StaticLayer.RotationInfo.RotationRandomOffset = FRotator(10.f, 45.f, 10.f);
+		StaticLayer.ScaleInfo.ScaleRandomOffset = FVector(0.25f);
+		StaticLayer.RenderInfo.bRandomizeSpawnChance = true;
+		StaticLayer.RenderInfo.SpawnChance = 0.7f;
+
+		FSplineMeshInitData& InstancedLayer = AddLayer(Layers, TEXT("Instanced"), EFlexSplineMeshType::StaticMesh);
+		InstancedLayer.MeshInfo.bUseInstancing = true;
+		InstancedLayer.LocationInfo.CoordinateSystem = EFlexCoordinateSystem::SplineFrame;
+		InstancedLayer.RotationInfo.CoordinateSystem = EFlexCoordinateSystem::SplineFrame;
+		InstancedLayer.LocationInfo.Location = FVector(0.f, 150.f, 0.f);
+
+		FSplineMeshInitData& DistanceLayer = AddLayer(Layers, TEXT("Distance"), EFlexSplineMeshType::StaticMesh);
+		DistanceLayer.MeshInfo.PlacementMode = EFlexPlacementMode::ByDistance;
+		DistanceLayer.MeshInfo.PlacementSpacing = 150.f;
+
+		FSplineMeshInitData& DynamicLayer = AddLayer(Layers, TEXT("Dynamic"), EFlexSplineMeshType::SplineMesh);
+		DynamicLayer.MeshInfo.bUseDynamicMesh = true;
+		DynamicLayer.ScaleInfo.bUseUniformScaleRandomOffset = true;
+		DynamicLayer.ScaleInfo.UniformScaleRandomOffset = 0.2f;
+
+		Actor->FinishSpawning(FTransform::Identity);
+	}
+
+	~FFlexSplineTestWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	/** Could the test mesh be loaded? Otherwise no layer renders anything */
+	bool IsValid() const
+	{
+		return Mesh != nullptr && Actor != nullptr;
+	}
+
+	UStaticMesh* Mesh = nullptr;
+	UWorld* World = nullptr;
+	AFlexSplineActor* Actor = nullptr;
+
+
+private:
+
+	FSplineMeshInitData& AddLayer(TMap<FName, FSplineMeshInitData>& Layers, const TCHAR* Name, EFlexSplineMeshType MeshType)
+	{
+		FSplineMeshInitData& Layer = Layers.Add(FName(Name));
+		Layer.Initialize();
+		Layer.MeshInfo.MeshType = MeshType;
+		Layer.MeshInfo.Mesh = Mesh;
+		return Layer;
+	}
+};
+
+#endif
@@ -20,60 +20,146 @@ public:
 	AFlexSplineActor();
 	void OnConstruction(const FTransform& Transform) override;
 	void PreInitializeComponents() override;
+#if WITH_EDITOR
+	void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	void PostEditChangeChainProperty(FPropertyChangedChainEvent& PropertyChangedEvent) override;
+	void PostEditUndo() override;
+	void PreSave(const class ITargetPlatform* TargetPlatform) override;
+#endif
 
 	int32 GetMeshCountForType(EFlexSplineMeshType MeshType) const;
 
+	/**
+	* Deform all spline mesh layers on the CPU and merge them into one static mesh per spatial cell.
+	* Baked layers render the merged meshes instead of a spline mesh per spline point.
+	* Merging runs on worker threads, but the merged static meshes are built synchronously on the game thread
+	*/
+	UFUNCTION(CallInEditor, Category = "FlexSpline|Bake")
+	void BakeSplineMeshLayers();
+
+	/** Remove all baked meshes, layers render their spline meshes again */
+	UFUNCTION(CallInEditor, Category = "FlexSpline|Bake")
+	void ClearBakedSplineMeshLayers();
+
 
 protected:
 
 	/** Spawns and initiates spline mesh components for each spline point */
 	void ConstructSplineMesh();
 
-	/** If mesh data has just been created initialize it with template */
+	/** Has only the actor's transform changed since the last construction, with nothing else to update? */
+	bool IsTransformOnlyConstruction(const FTransform& Transform) const;
+
+	/** Are point numbers or the up direction of any layer shown? */
+	bool IsDebugInformationShown() const;
+
+	/** Move world space debug information along with the actor, instead of running a construction */
+	void UpdateDebugTransforms();
+
+#if WITH_EDITOR
+	/** Update stages required by a change of the actor's member @param MemberName, bitmask of EFlexUpdateFlags */
+	static uint8 ClassifyActorProperty(FName MemberName);
+#endif
+
+	/** Schedule update stages for the next construction, for the layer at @param LayerIndex or all layers if INDEX_NONE */
+	void RequestUpdate(uint8 Updates, int32 LayerIndex);
+
+	/** If mesh data has just been created initialize it with template. Caches name, index and seed of all layers */
 	void InitializeNewMeshData();
 
-	/** Create new point data if there is a new spline point */
-	void AddPointDataEntries();
+	/** Match current spline points against the point data of the last construction */
+	void DiffSplinePoints(struct FFlexPointDiff& OutPointDiff) const;
+
+	/** Compact point data to the current spline points, inserted points get a new identity */
+	void ApplyPointDataDiff(const struct FFlexPointDiff& PointDiff);
+
+	/** Compact mesh components of all layers, components of deleted points are released */
+	void ApplyMeshDiff(const struct FFlexPointDiff& PointDiff);
+
+	/** Find all points whose inputs have changed since the last construction */
+	void UpdateDirtyPoints();
 
-	/** Remove point data associated with deleted spline point */
-	void RemovePointDataEntries(const TArray<int32>& DeletedIndices);
+	/** Hash the settings of each layer, layers whose settings have changed are placed again at all points */
+	void UpdateLayerConfigs();
 
-	/** Create new mesh components if there are fewer meshes than spline points */
-	void InitDataAddMeshes();
+	/** Re-sample the spline at all dirty or shifted points */
+	void UpdateSplineSamples();
 
-	/** Remove mesh components if there are more meshes than spline points */
-	void InitDataRemoveMeshes(const TArray<int32>& DeletedIndices);
+	/** Carry the rotation minimizing frame along the spline, from the first changed sample on */
+	void UpdateSplineFrames();
+
+	/** Sample the arc length of changed segments, for layers that place their meshes by distance */
+	void UpdateArcLengths();
+
+	/** Recompute placement masks of layers whose settings have changed, or whose points have shifted */
+	void UpdatePlacementMasks();
 
 	/** Bring point data identifiers up to date */
 	void UpdatePointData();
 
-	/** Adjust text renderer position and text according to points and meshes */
+	/** Pass point numbers and up directions of dirty points to the debug component, editor only */
 	void UpdateDebugInformation();
 
 
-	/** Set mesh values according to mesh and point data */
-	void UpdateMeshComponents();
+	/** Set mesh values according to mesh and point data, applies the solved placements of all layers on the game thread */
+	void UpdateMeshComponents(const TArray<FFlexLayerSolve>& LayerSolves);
+
+	/** Solve placements of all layers at all dirty points, or all points if @param bSolveAll, in parallel. One entry per layer in @param OutLayerSolves */
+	void SolveMeshComponents(TArray<FFlexLayerSolve>& OutLayerSolves, bool bSolveAll) const;
+
+	/** Merge straight runs of consecutive segments of coalesced layers into their first segment, the others are hidden */
+	void CoalesceSegments(TArray<FFlexLayerSolve>& LayerSolves) const;
+
+	/** Hash of all inputs of the current construction that the construction cache depends on */
+	uint32 GetConstructionInputHash() const;
+
+	/** Fill placement masks and @param OutLayerSolves from the construction cache, if it matches the current inputs and everything is rebuilt */
+	bool ReadConstructionCache(TArray<FFlexLayerSolve>& OutLayerSolves);
+
+#if WITH_EDITOR
+	/** Store the placement of all meshes from the last construction in the construction cache */
+	void WriteConstructionCache();
+#endif
+
+	/** Solve placement of the layer's mesh at this index through the generic path, which branches on all layer settings per point. Thread safe, does not touch any UObject */
+	void SolveMesh(const FSplineMeshInitData& MeshInitData, int32 Index, FFlexMeshSolveResult& OutResult) const;
+
+	/** Push material and collision settings of a layer to its existing components, without placing any mesh again */
+	void UpdateLayerSettings(FSplineMeshInitData& MeshInitData);
 
 	/** Called by UpdateMeshComponents, specialized for spline meshes */
-	void UpdateSplineMesh(const FSplineMeshInitData& MeshInitData, class USplineMeshComponent* SplineMesh,
-						  int32 CurrentIndex);
+	void UpdateSplineMesh(class USplineMeshComponent* SplineMesh, const FFlexSplineMeshParams& Params);
 
 	/** Called by UpdateMeshComponents, specialized for static meshes */
-	void UpdateStaticMesh(const FSplineMeshInitData& MeshInitData, class UStaticMeshComponent* StaticMesh,
-						  int32 CurrentIndex);
+	void UpdateStaticMesh(class UStaticMeshComponent* StaticMesh, const FTransform& Transform);
 
+	/** Called by UpdateMeshComponents, writes all instance transforms of an instanced static mesh layer in one batch */
+	void UpdateInstancedMesh(FSplineMeshInitData& MeshInitData, const FFlexLayerSolve& LayerSolve);
 
-protected:
+	/** Called by UpdateInstancedMesh for layers placed by distance, places all meshes from the first changed segment on, or all of them if @param bUpdateAll */
+	void UpdateDistanceInstances(FSplineMeshInitData& MeshInitData, class UHierarchicalInstancedStaticMeshComponent* InstancedMesh, bool bUpdateAll);
 
-	/** Return data's layer name, if available */
-	FName GetLayerName(const FSplineMeshInitData& MeshInitData) const;
+	/** Called by UpdateMeshComponents, deforms and uploads changed segments of a dynamic mesh layer */
+	void UpdateDynamicMesh(FSplineMeshInitData& MeshInitData, const FFlexLayerSolve& LayerSolve);
 
-	/** Find and return all indices of spline mesh that were deleted since last update */
-	void GetDeletedIndices(TArray<int32>& OutIndexArray) const;
+	/** Called by UpdateMeshComponents, shows the merged meshes of a baked layer */
+	void UpdateBakedMesh(FSplineMeshInitData& MeshInitData);
 
-	/** Find best position for the text renderer at this index */
+	/** Swap layer to the given baked meshes once baking has finished */
+	void ApplyBakedMeshes(FName LayerName, const TArray<UStaticMesh*>& NewBakedMeshes);
+
+
+protected:
+
+	/** Do meshes at this index need to be re-evaluated during the current construction? */
+	bool IsPointDirty(int32 Index) const;
+
+	/** Find best position for the point number at this index */
 	FVector GetTextPosition(int32 Index) const;
 
+	/** Is the mesh of this layer at the current index visible at all? Reads the layer's placement mask */
+	bool CanRender(const FSplineMeshInitData& MeshInitData, int32 CurrentIndex) const;
+
 	/** Is rendering allowed, given the current index? */
 	bool CanRenderFromMode(const FSplineMeshInitData& MeshInitData, int32 CurrentIndex, int32 FinalIndex) const;
 
@@ -98,17 +184,23 @@ protected:
 	/** Get up direction for spline according to chosen local space */
 	FVector CalculateUpDirection(const FSplineMeshInitData& MeshInitData, const FSplinePointData& PointData, int32 Index) const;
 
-	/** Calculate location for spline mesh and apply to param outSplineMesh */
-	void SetSplineMeshLocation(const FSplineMeshInitData& MeshInitData, class USplineMeshComponent* OutSplineMesh, int32 Index);
+	/** Compute transform of the mesh of a layer placed by distance, the @param MeshIndex th mesh along the spline at @param InputKey */
+	FTransform CalculateDistanceTransform(const FSplineMeshInitData& MeshInitData, int32 MeshIndex, float InputKey) const;
 
-	/**
-	* Create a new mesh component of class meshType, add to mesh init data array.
-	* If no valid index is specified, it is appended
-	*/
-	class UStaticMeshComponent* CreateMeshComponent(UClass* MeshType, FSplineMeshInitData& MeshInitData, int32 Index = -1);
+	/** Compute all spline mesh parameters for the segment starting at this index */
+	FFlexSplineMeshParams CalculateSplineMeshParams(const FSplineMeshInitData& MeshInitData, int32 Index) const;
+
+	/** Calculate location for spline mesh and write it to @param OutParams */
+	void CalculateSplineMeshLocation(const FSplineMeshInitData& MeshInitData, int32 Index, FFlexSplineMeshParams& OutParams) const;
+
+	/** Rent a mesh component of class meshType from the component pool, store it in the mesh init data slot at @param Index */
+	class UStaticMeshComponent* CreateMeshComponent(UClass* MeshType, FSplineMeshInitData& MeshInitData, int32 Index);
+
+	/** Create the instanced mesh component that renders all meshes of an instanced layer */
+	class UHierarchicalInstancedStaticMeshComponent* CreateInstancedMeshComponent(FSplineMeshInitData& MeshInitData);
 
-	/** Create arrow component, add to Actor root, cache inside @param MeshInitData */
-	class UArrowComponent* CreateArrowComponent(FSplineMeshInitData& MeshInitData);
+	/** Create the dynamic mesh component that renders all spline meshes of a dynamic layer */
+	class UProceduralMeshComponent* CreateDynamicMeshComponent(FSplineMeshInitData& MeshInitData);
 
 
 protected:
@@ -116,6 +208,12 @@ protected:
 	UPROPERTY(VisibleAnywhere, Category = "FlexSpline", meta = (AllowPrivateAccess = "true"))
 	class USplineComponent* SplineComponent;
 
+#if WITH_EDITORONLY_DATA
+	/** Draws point numbers and up directions of all points in one batch */
+	UPROPERTY()
+	class UFlexSplineDebugComponent* DebugComponent;
+#endif
+
 
 protected:
 
@@ -136,6 +234,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "FlexSpline|Global", meta = (DisplayName = "Loop"))
 	EFlexGlobalConfigType LoopConfig;
 
+	/** Seed for all randomized offsets and spawn chances. Change it to get a different variation of the same spline */
+	UPROPERTY(EditAnywhere, Category = "FlexSpline|Global")
+	int32 RandomSeed;
+
 	/** Blueprint for new "Mesh Layer" entries */
 	UPROPERTY(EditAnywhere, Category = "FlexSpline|Global", meta = (DisplayName = "Mesh Layer Template"))
 	FSplineMeshInitData MeshDataTemplate;
@@ -145,11 +247,11 @@ protected:
 	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = "FlexSpline")
 	bool bShowPointNumbers;
 
-	/** Spline index text renderer size */
+	/** Height of the point numbers in world units */
 	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = "FlexSpline", meta = (ClampMin = "0.0", UIMax = "500.0"))
 	float PointNumberSize;
 
-	/** Debug up direction arrow component size */
+	/** Debug up direction arrow length, in multiples of 80 units */
 	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = "FlexSpline", meta = (ClampMin = "0.0", UIMax = "10.0"))
 	float UpDirectionArrowSize;
 
@@ -157,10 +259,14 @@ protected:
 	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = "FlexSpline", meta = (ClampMin = "0.0", UIMax = "200.0"))
 	float UpDirectionArrowOffset;
 
-	/** Color of the spline point text renderer */
+	/** Color of the point numbers */
 	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = "FlexSpline")
 	FColor TextRenderColor;
 
+	/** Edge length of the spatial cells baked spline mesh layers are split into. Each cell becomes one static mesh */
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = "FlexSpline|Bake", meta = (ClampMin = "100.0", UIMax = "100000.0"))
+	float BakeCellSize;
+
 
 	/**
 	* Mesh configuration for each spline point, resizes automatically
@@ -172,12 +278,70 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "FlexSpline", meta = (DisplayName = "Mesh Layers", NoElementDuplicate))
 	TMap<FName, FSplineMeshInitData> MeshDataInitMap;
 
+	/** Placement of all meshes at the last save, used instead of evaluating the spline on load */
+	UPROPERTY()
+	FFlexConstructionCache ConstructionCache;
+
 
 private:
 
 	/** Cache lastly generated MeshDataInitMap key to circumvent strange engine behavior */
 	FName LastUsedKey;
 
+	/** Owns all components of the mesh layers, released components are reused instead of destroyed */
+	UPROPERTY(Transient)
+	FFlexComponentPool ComponentPool;
+
+	/** Identifier for the next inserted spline point */
+	UPROPERTY()
+	int32 NextPointID;
+
+	/** First point whose index has shifted during the current construction, INDEX_NONE if none */
+	int32 FirstShiftedPointIndex;
+
+	/** Hash of each spline point's inputs at the last construction, used to find changed points */
+	TArray<uint32> PointInputHashes;
+
+	/** Points whose meshes are re-evaluated during the current construction */
+	TBitArray<> DirtyPoints;
+
+	/** Spline values at each point, shared by all layers */
+	FFlexSplineSamples SplineSamples;
+
+	/** First point whose rotation minimizing frame has changed during the current construction, INDEX_NONE if none */
+	int32 FirstChangedFrameIndex;
+
+	/** Solved placements of the current construction, kept between constructions to reuse their memory */
+	TArray<FFlexLayerSolve> CurrentLayerSolves;
+
+	/** Point input hashes of the current construction, swapped with PointInputHashes to reuse their memory */
+	TArray<uint32> ScratchPointInputHashes;
+
+	/** Instance transforms and removed instance indices passed to instanced components, kept to reuse their memory */
+	TArray<FTransform> ScratchInstanceTransforms;
+	TArray<int32> ScratchRemovedInstances;
+
+	/** Closed loop state of the spline at the last construction */
+	bool bWasClosedLoop;
+
+	/** Is everything rebuilt during the current construction? */
+	bool bFullRebuild;
+
+	/** Rebuild everything with the next construction, e.g. because layer or global settings have changed */
+	bool bFullRebuildPending;
+
+	/** Refresh point numbers and arrows of all points with the next construction, not only those of dirty points */
+	bool bDebugRefreshPending;
+
+	/** Has the current property change already been routed from its property chain? */
+	bool bPropertyChangeRouted;
+
+	/** Actor transform at the last construction, used to detect constructions caused by moving the actor */
+	FTransform LastConstructionTransform;
+
 	/** Details customizer class needs access to all members */
 	friend class FFlexSplineNodeBuilder;
+
+	/** Automation tests run single constructions and solves */
+	friend struct FFlexSplineTestAccess;
 };
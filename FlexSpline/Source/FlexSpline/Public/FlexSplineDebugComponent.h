@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "FlexSplineDebugComponent.generated.h"
+
+class UCanvas;
+class APlayerController;
+
+/** Up direction of one layer's mesh at one spline point, in world space */
+struct FFlexDebugArrow
+{
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	FColor Color = FColor::White;
+	bool bVisible = false;
+};
+
+/**
+* Editor only visualization of a Flex Spline's point numbers and up directions.
+* Draws the labels and arrows of all points and layers in one batch on the editor viewport's canvas,
+* instead of a text render and an arrow component per spline point
+*/
+UCLASS(ClassGroup = FlexSpline)
+class FLEXSPLINE_API UFlexSplineDebugComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UFlexSplineDebugComponent();
+
+#if WITH_EDITOR
+	void OnRegister() override;
+	void OnUnregister() override;
+#endif
+
+	/** Resize to @param NumPoints points with @param NumLayers arrows each. Entries of remaining points are kept as long as the layer count does not change */
+	void SetNum(int32 NumPoints, int32 NumLayers);
+
+	/** Remove all labels and arrows */
+	void Reset();
+
+	/** Has nothing been stored since the last reset? */
+	bool IsEmpty() const { return LabelLocations.Num() == 0; }
+
+	/** Show the index of the spline point at @param PointIndex at @param Location */
+	void SetLabel(int32 PointIndex, const FVector& Location);
+
+	/** Show an arrow for the layer at @param LayerIndex at this point, from @param Start to @param End */
+	void SetArrow(int32 PointIndex, int32 LayerIndex, const FVector& Start, const FVector& End, const FColor& Color);
+
+	/** Hide the arrow of the layer at @param LayerIndex at this point */
+	void ClearArrow(int32 PointIndex, int32 LayerIndex);
+
+	/** Are point numbers drawn? */
+	bool bShowLabels;
+
+	/** Color of the point numbers */
+	FColor LabelColor;
+
+	/** Height of the point numbers in world units, like the world size of a text render component */
+	float LabelWorldSize;
+
+
+private:
+
+#if WITH_EDITOR
+	/** Draw all labels and arrows of the owning actor, called once per editor viewport and frame */
+	void DrawVisualization(UCanvas* Canvas, APlayerController* PlayerController) const;
+#endif
+
+	/** World location of each spline point's label */
+	TArray<FVector> LabelLocations;
+
+	/** Text of each label, only depends on the index so it is built once instead of every frame */
+	TArray<FText> LabelTexts;
+
+	/** One arrow per spline point and layer, indexed PointIndex * NumLayers + LayerIndex */
+	TArray<FFlexDebugArrow> Arrows;
+
+	/** Number of layers at the last resize */
+	int32 NumLayers;
+
+	/** Registration with the debug draw service */
+	FDelegateHandle DrawHandle;
+};
@@ -19,7 +19,9 @@ enum class EFlexCoordinateSystem : uint8
 	/** Use coordinates local to the related spline point */
 	SplinePoint,
 	/** Use coordinates local to the entire blueprint instance */
-	SplineSystem
+	SplineSystem,
+	/** Use a rotation minimizing frame carried along the spline, which does not flip or twist on winding splines */
+	SplineFrame
 };
 
 /** Generically defines where given configurations apply */
@@ -44,6 +46,16 @@ enum class EFlexSplineMeshType : uint8
 	StaticMesh
 };
 
+/** How the meshes of a layer are distributed along the spline */
+UENUM(BlueprintType)
+enum class EFlexPlacementMode : uint8
+{
+	/** One mesh at each spline point */
+	PerPoint,
+	/** Meshes evenly spaced by distance along the spline, independent of the number of spline points */
+	ByDistance
+};
+
 /** At what place of the spline should a mesh be rendered */
 UENUM(BlueprintType, meta = (Bitflags))
 enum class EFlexSplineRenderMode : uint8
@@ -67,3 +79,20 @@ enum class EFlexGeneralFlags : uint8
 	/** Enable Looping for this Mesh Layer */
 	Loop
 };
+
+/** Construction stages a property change requires, used to route editor changes to partial updates */
+enum class EFlexUpdateFlags : uint8
+{
+	/** Material overrides of existing components */
+	Material,
+	/** Collision settings of existing components */
+	Collision,
+	/** Placement of all meshes of a layer */
+	Transform,
+	/** Placement mask and placement of all meshes of a layer */
+	Visibility,
+	/** Point numbers and up direction arrows only */
+	Debug,
+	/** Anything else, requires a full rebuild */
+	Structural
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Modules/ModuleManager.h"
+#include "Stats/Stats.h"
 
 class FFlexSplineModule : public IModuleInterface
 {
@@ -13,3 +14,4 @@ public:
 
 
 DECLARE_LOG_CATEGORY_EXTERN(FlexLog, Log, All);
+DECLARE_STATS_GROUP(TEXT("FlexSpline"), STATGROUP_FlexSpline, STATCAT_Advanced);
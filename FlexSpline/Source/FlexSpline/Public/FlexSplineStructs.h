@@ -5,7 +5,14 @@
 #include "FlexSplineStructs.generated.h"
 
 using FStaticMeshWeakPtr = TWeakObjectPtr<class UStaticMeshComponent>;
-using FArrowWeakPtr = TWeakObjectPtr<class UArrowComponent>;
+using FInstancedMeshWeakPtr = TWeakObjectPtr<class UHierarchicalInstancedStaticMeshComponent>;
+using FDynamicMeshWeakPtr = TWeakObjectPtr<class UProceduralMeshComponent>;
+
+struct FFlexDeformSourceMesh;
+struct FFlexDynamicMeshScratch;
+class UActorComponent;
+class USceneComponent;
+class AActor;
 
 USTRUCT(BlueprintType)
 struct FFlexMeshInfo
@@ -28,13 +35,78 @@ struct FFlexMeshInfo
 	UPROPERTY(EditAnywhere, Category = FlexSpline)
 	UMaterialInterface* MeshMaterial;
 
+	/**
+	* Render all static meshes of this layer as instances of one hierarchical instanced static mesh component,
+	* instead of spawning a component per spline point. Only relevant for static meshes
+	*/
+	UPROPERTY(EditAnywhere, Category = FlexSpline, meta = (EditCondition = "MeshType == EFlexSplineMeshType::StaticMesh"))
+	uint32 bUseInstancing : 1;
+
+	/**
+	* Render all spline meshes of this layer as one dynamic mesh, deformed on the CPU,
+	* instead of spawning a spline mesh component per spline point. Only relevant for spline meshes
+	*/
+	UPROPERTY(EditAnywhere, Category = FlexSpline, meta = (EditCondition = "MeshType == EFlexSplineMeshType::SplineMesh"))
+	uint32 bUseDynamicMesh : 1;
+
+	/**
+	* Split each segment into pieces about as long as the mesh along its forward axis, so long segments repeat the mesh
+	* instead of stretching it. Only relevant for spline meshes, subdivided layers are always rendered as one dynamic mesh.
+	* The mesh is deformed on the CPU, so it needs "Allow CPU Access" enabled to render in cooked builds
+	*/
+	UPROPERTY(EditAnywhere, Category = FlexSpline, meta = (EditCondition = "MeshType == EFlexSplineMeshType::SplineMesh"))
+	uint32 bSubdivideSegments : 1;
+
+	/** Merge consecutive segments into one spline mesh while the spline runs straight within the tolerances below. Only relevant for spline meshes */
+	UPROPERTY(EditAnywhere, Category = FlexSpline, meta = (EditCondition = "MeshType == EFlexSplineMeshType::SplineMesh"))
+	uint32 bCoalesceSegments : 1;
+
+	/** Largest deviation in degrees of spline direction, up direction and roll within merged segments */
+	UPROPERTY(EditAnywhere, Category = FlexSpline, meta = (ClampMin = "0.0", ClampMax = "45.0", EditCondition = "MeshType == EFlexSplineMeshType::SplineMesh && bCoalesceSegments"))
+	float CoalesceAngleTolerance;
+
+	/** Largest deviation of the mesh scale within merged segments */
+	UPROPERTY(EditAnywhere, Category = FlexSpline, meta = (ClampMin = "0.0", EditCondition = "MeshType == EFlexSplineMeshType::SplineMesh && bCoalesceSegments"))
+	float CoalesceScaleTolerance;
+
+	/**
+	* Place a mesh at each spline point, or space meshes evenly along the spline. Only relevant for static meshes,
+	* meshes placed by distance are always rendered as instances
+	*/
+	UPROPERTY(EditAnywhere, Category = FlexSpline, meta = (EditCondition = "MeshType == EFlexSplineMeshType::StaticMesh"))
+	EFlexPlacementMode PlacementMode;
+
+	/** Distance between two meshes along the spline. Only relevant for static meshes placed by distance */
+	UPROPERTY(EditAnywhere, Category = FlexSpline, meta = (ClampMin = "1.0", EditCondition = "MeshType == EFlexSplineMeshType::StaticMesh && PlacementMode == EFlexPlacementMode::ByDistance"))
+	float PlacementSpacing;
+
 	FFlexMeshInfo(EFlexSplineAxis InForwardAxis = EFlexSplineAxis::X, EFlexSplineMeshType InType = EFlexSplineMeshType::SplineMesh):
 		MeshType(InType),
 		MeshForwardAxis(InForwardAxis),
 		Mesh(nullptr),
-		MeshMaterial(nullptr)
+		MeshMaterial(nullptr),
+		bUseInstancing(false),
+		bUseDynamicMesh(false),
+		bSubdivideSegments(false),
+		bCoalesceSegments(false),
+		CoalesceAngleTolerance(1.f),
+		CoalesceScaleTolerance(0.01f),
+		PlacementMode(EFlexPlacementMode::PerPoint),
+		PlacementSpacing(100.f)
 	{
 	}
+
+	/** Are consecutive straight segments of this layer merged into one spline mesh? */
+	bool IsCoalesced() const { return MeshType == EFlexSplineMeshType::SplineMesh && bCoalesceSegments; }
+
+	/** Are meshes of this layer spaced by distance instead of placed at each spline point? */
+	bool IsPlacedByDistance() const { return MeshType == EFlexSplineMeshType::StaticMesh && PlacementMode == EFlexPlacementMode::ByDistance; }
+
+	/** Are all meshes of this layer rendered by a single instanced component? */
+	bool IsInstanced() const { return MeshType == EFlexSplineMeshType::StaticMesh && (bUseInstancing || PlacementMode == EFlexPlacementMode::ByDistance); }
+
+	/** Are all meshes of this layer rendered by a single dynamic mesh component? */
+	bool IsDynamic() const { return MeshType == EFlexSplineMeshType::SplineMesh && (bUseDynamicMesh || bSubdivideSegments); }
 };
 
 USTRUCT(BlueprintType)
@@ -213,6 +285,148 @@ struct FFlexUpVectorInfo
 };
 
 
+/**
+* Parameters of one spline mesh segment, as they are applied to a spline mesh component.
+* Locations and tangents are local to the Flex Spline Actor
+*/
+USTRUCT()
+struct FFlexSplineMeshParams
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector StartLocation;
+
+	UPROPERTY()
+	FVector StartTangent;
+
+	UPROPERTY()
+	FVector EndLocation;
+
+	UPROPERTY()
+	FVector EndTangent;
+
+	UPROPERTY()
+	FVector2D StartScale;
+
+	UPROPERTY()
+	FVector2D EndScale;
+
+	UPROPERTY()
+	FVector2D StartOffset;
+
+	UPROPERTY()
+	FVector2D EndOffset;
+
+	UPROPERTY()
+	float StartRoll;
+
+	UPROPERTY()
+	float EndRoll;
+
+	UPROPERTY()
+	FVector UpDirection;
+
+	UPROPERTY()
+	EFlexSplineAxis ForwardAxis;
+
+	/** Transform of the spline mesh relative to the spline, only X scale is driven by the layer */
+	UPROPERTY()
+	FVector RelativeLocation;
+
+	UPROPERTY()
+	FRotator RelativeRotation;
+
+	UPROPERTY()
+	float RelativeScaleX;
+
+	FFlexSplineMeshParams():
+		StartLocation(0.f),
+		StartTangent(0.f),
+		EndLocation(0.f),
+		EndTangent(0.f),
+		StartScale(1.f, 1.f),
+		EndScale(1.f, 1.f),
+		StartOffset(0.f, 0.f),
+		EndOffset(0.f, 0.f),
+		StartRoll(0.f),
+		EndRoll(0.f),
+		UpDirection(0.f, 0.f, 1.f),
+		ForwardAxis(EFlexSplineAxis::X),
+		RelativeLocation(0.f),
+		RelativeRotation(0.f),
+		RelativeScaleX(1.f)
+	{
+	}
+
+	bool operator==(const FFlexSplineMeshParams& Other) const
+	{
+		return StartLocation == Other.StartLocation
+			&& StartTangent == Other.StartTangent
+			&& EndLocation == Other.EndLocation
+			&& EndTangent == Other.EndTangent
+			&& StartScale == Other.StartScale
+			&& EndScale == Other.EndScale
+			&& StartOffset == Other.StartOffset
+			&& EndOffset == Other.EndOffset
+			&& StartRoll == Other.StartRoll
+			&& EndRoll == Other.EndRoll
+			&& UpDirection == Other.UpDirection
+			&& ForwardAxis == Other.ForwardAxis
+			&& RelativeLocation == Other.RelativeLocation
+			&& RelativeRotation == Other.RelativeRotation
+			&& RelativeScaleX == Other.RelativeScaleX;
+	}
+
+	bool operator!=(const FFlexSplineMeshParams& Other) const
+	{
+		return !(*this == Other);
+	}
+};
+
+
+/**
+* Runtime state of a layer whose spline meshes are rendered as one CPU deformed dynamic mesh
+*/
+struct FFlexDynamicMeshState
+{
+	/** Renders all segments of the layer, split into sections of consecutive spline points */
+	FDynamicMeshWeakPtr Component;
+
+	/** CPU copy of the layer's mesh, deformed along each segment */
+	TSharedPtr<FFlexDeformSourceMesh, ESPMode::ThreadSafe> SourceMesh;
+
+	/** Mesh the source mesh was copied from */
+	TWeakObjectPtr<UStaticMesh> SourceMeshAsset;
+
+	/** Buffers of the chunks deformed by the last partial update, reused by the next one */
+	TSharedPtr<FFlexDynamicMeshScratch, ESPMode::ThreadSafe> Scratch;
+
+	/** Segment parameters and visibility per spline point, as last uploaded. Used to only re-upload changed sections */
+	TArray<FFlexSplineMeshParams> SegmentParams;
+	TBitArray<> SegmentVisibility;
+
+	/** Was collision generated with the last upload? */
+	bool bHasCollision = false;
+
+	/** Were segments subdivided with the last upload? */
+	bool bSubdivided = false;
+};
+
+/**
+* Hashes of what has last been pushed to a per point mesh component, used to skip components whose
+* effective parameters have not changed. Zero if unknown, e.g. for new components
+*/
+struct FFlexAppliedMeshState
+{
+	/** Collision, mesh and material */
+	uint32 SettingsHash = 0;
+
+	/** Spline mesh parameters or relative transform */
+	uint32 PlacementHash = 0;
+};
+
+
 /**
 * Stores info on what meshes and which default values on each spline point are initialized
 */
@@ -261,25 +475,79 @@ struct FSplineMeshInitData
 	*/
 	TArray<FStaticMeshWeakPtr> MeshComponentsArray;
 
-	/** Shows the spline up vector at each spline point */
-	TArray<FArrowWeakPtr> ArrowSplineUpIndicatorArray;
+	/** Last applied state of each mesh component, one per spline point */
+	TArray<FFlexAppliedMeshState> AppliedMeshStates;
+
+	/**
+	* Holds all static mesh instances of this layer if instancing is enabled.
+	* Mesh components array entries stay empty in that case
+	*/
+	FInstancedMeshWeakPtr InstancedMeshComponent;
+
+	/**
+	* Instance index of each spline point's mesh inside the instanced mesh component, INDEX_NONE if not rendered.
+	* For layers placed by distance, index of the first instance on the segment starting at each spline point
+	*/
+	TArray<int32> InstanceIndices;
+
+	/**
+	* Merged static meshes baked from this layer's spline meshes, one per spatial cell.
+	* If set, they are rendered instead of a spline mesh per spline point
+	*/
+	UPROPERTY(VisibleAnywhere, AdvancedDisplay, Category = FlexSpline)
+	TArray<UStaticMesh*> BakedMeshes;
+
+	/** Renders the baked meshes, one component per baked mesh */
+	TArray<FStaticMeshWeakPtr> BakedMeshComponentsArray;
+
+	/** Renders all spline meshes of this layer if dynamic mesh rendering is enabled */
+	FFlexDynamicMeshState DynamicMesh;
+
+	/** Key of this layer in the layer map, cached once per construction */
+	FName LayerName;
+
+	/** Position of this layer in the layer map, cached once per construction */
+	int32 LayerIndex;
+
+	/** Seed for all randomized values of this layer, derived from the actor's seed and the layer's name */
+	uint32 LayerSeed;
+
+	/** Spline points that render this layer's mesh, from active flag, loop state, spawn chance and render mode */
+	TBitArray<> PlacementMask;
+
+	/** Hash of the layer settings the placement mask was computed from */
+	uint32 PlacementHash;
+
+	/** Update stages requested by property changes of this layer since the last construction, bitmask of EFlexUpdateFlags */
+	uint8 PendingUpdates;
+
+	/** Hash of all layer and global settings the placement of this layer's meshes depends on, at the last construction */
+	uint32 ConfigHash;
+
+	/** Hash of the material and collision settings of this layer, at the last construction */
+	uint32 SettingsHash;
 
 
 	FSplineMeshInitData()
-		: bTemplatedInitialized(false)
+		: LayerIndex(INDEX_NONE),
+		  LayerSeed(0),
+		  PlacementHash(0),
+		  PendingUpdates(0),
+		  ConfigHash(0),
+		  SettingsHash(0),
+		  bTemplatedInitialized(false)
 	{
 		SET_BIT(GeneralInfo, EFlexGeneralFlags::Active);
 	}
 
-	/** Delete all spline meshes and arrows on destruction */
-	~FSplineMeshInitData();
-
 	bool operator==(const FSplineMeshInitData& Other) const
 	{
 		return this == &Other;
 	}
 
 	bool IsInitialized() const { return bTemplatedInitialized; }
+	bool IsBaked() const { return MeshInfo.MeshType == EFlexSplineMeshType::SplineMesh && BakedMeshes.Num() > 0; }
+	bool IsSolvedPerPoint() const { return !IsBaked() && !MeshInfo.IsPlacedByDistance(); }
 	void Initialize() { bTemplatedInitialized = true; }
 
 
@@ -346,12 +614,13 @@ struct FSplinePointData
 	FRotator SMRotation;
 
 
-	/** Displays the index for the associated spline point */
+	/** Persistent identifier, stays with the point when other points are inserted or deleted */
 	UPROPERTY()
-	class UTextRenderComponent* IndexTextRenderer;
+	int32 ID;
 
-	/** Unique identifier, hash-value */
-	uint32 ID;
+	/** Hash of the point's local location at the last construction, used to match points against the spline */
+	UPROPERTY()
+	uint32 LocationHash;
 
 	/** CONSTRUCTOR */
 	FSplinePointData():
@@ -366,8 +635,192 @@ struct FSplinePointData
 		SMLocationOffset(0.f),
 		SMScale(0.f),
 		SMRotation(0.f),
-		IndexTextRenderer(nullptr),
-		ID(0)
+		ID(INDEX_NONE),
+		LocationHash(0)
 		{
 		}
-};
\ No newline at end of file
+};
+
+/**
+* Arc length of the spline, sampled at evenly spaced input keys along each segment. Maps distances along the spline
+* to input keys without querying the spline component. Segments are only sampled again if one of their points has changed
+*/
+struct FFlexArcLengthTable
+{
+	/** Samples per segment, the last one at the segment end */
+	static constexpr int32 SamplesPerSegment = 16;
+
+	/** Distance from the segment start at each sample, SamplesPerSegment entries per segment */
+	TArray<float> SegmentSamples;
+
+	/** Distance along the spline at the start of each segment, plus the total length at the end */
+	TArray<float> SegmentDistances;
+
+	int32 NumSegments() const { return FMath::Max(SegmentDistances.Num() - 1, 0); }
+	float GetLength() const { return SegmentDistances.Num() > 0 ? SegmentDistances.Last() : 0.f; }
+
+	/** Spline input key at @param Distance along the spline, clamped to the spline */
+	float GetInputKeyAtDistance(float Distance) const;
+
+	void Reset()
+	{
+		SegmentSamples.Reset();
+		SegmentDistances.Reset();
+	}
+};
+
+/**
+* Spline values at each spline point in local space, stored as one array per value.
+* Sampled once per construction and shared by all layers, instead of querying the spline component per layer
+*/
+struct FFlexSplineSamples
+{
+	TArray<FVector> Locations;
+	TArray<FVector> Tangents;
+	TArray<FVector> Directions;
+	TArray<FRotator> Rotations;
+	TArray<FVector> Scales;
+
+	/** Rotation minimizing frame at each point, only built while a layer uses EFlexCoordinateSystem::SplineFrame */
+	TArray<FQuat> Frames;
+
+	/** Arc length along each segment, only built while a layer places its meshes by distance */
+	FFlexArcLengthTable ArcLengths;
+
+	int32 Num() const { return Locations.Num(); }
+
+	void SetNum(int32 NumPoints)
+	{
+		Locations.SetNumUninitialized(NumPoints);
+		Tangents.SetNumUninitialized(NumPoints);
+		Directions.SetNumUninitialized(NumPoints);
+		Rotations.SetNumUninitialized(NumPoints);
+		Scales.SetNumUninitialized(NumPoints);
+	}
+};
+
+/**
+* Placement of one layer's mesh at one spline point. Solved without touching any UObject, applied to components afterwards
+*/
+struct FFlexMeshSolveResult
+{
+	/** Segment parameters, only set for visible spline meshes */
+	FFlexSplineMeshParams SplineParams;
+
+	/** Relative transform, only set for visible static meshes */
+	FTransform Transform;
+
+	/** Collision of the mesh, no collision if it is not visible */
+	TEnumAsByte<ECollisionEnabled::Type> Collision = ECollisionEnabled::NoCollision;
+
+	bool bVisible = false;
+};
+
+/**
+* Solved placements of one layer for all points that are re-evaluated during the current construction
+*/
+struct FFlexLayerSolve
+{
+	/** Solved spline point indices, ascending */
+	TArray<int32> Indices;
+
+	/** One result per solved index */
+	TArray<FFlexMeshSolveResult> Results;
+
+	/** Have all spline points been solved? */
+	bool bSolvedAll = false;
+
+	/** Clear for the next construction, keeps the capacity of all arrays */
+	void Reset()
+	{
+		Indices.Reset();
+		Results.Reset();
+		bSolvedAll = false;
+	}
+};
+
+/**
+* Owns every component an actor creates for its mesh layers. Released mesh components are
+* unregistered and kept for reuse, so changing layer settings does not create and garbage collect UObjects
+*/
+USTRUCT()
+struct FFlexComponentPool
+{
+	GENERATED_BODY()
+
+	/** Upper limit of pooled components per class, further released components are destroyed */
+	static constexpr int32 MaxPooledPerClass = 1024;
+
+	/** Get a registered component of exactly @param ComponentClass attached to @param Parent, pooled components are reused first */
+	UActorComponent* Rent(AActor* Owner, UClass* ComponentClass, USceneComponent* Parent);
+
+	template<typename T>
+	T* Rent(AActor* Owner, USceneComponent* Parent, UClass* ComponentClass = T::StaticClass())
+	{
+		return CastChecked<T>(Rent(Owner, ComponentClass, Parent));
+	}
+
+	/** Unregister the component and keep it for reuse. Components that can't be reused are destroyed */
+	void Release(UActorComponent* Component);
+
+	/** Release all rented components that are not contained in @param InUse, e.g. those of removed layers */
+	void ReleaseUnused(const TSet<UActorComponent*>& InUse);
+
+
+private:
+
+	/** Pooled components of the given class, nullptr if the class is not reused */
+	TArray<UActorComponent*>* GetPooled(UClass* ComponentClass);
+
+	/** Components currently used by mesh layers */
+	UPROPERTY(Transient)
+	TSet<UActorComponent*> Rented;
+
+	UPROPERTY(Transient)
+	TArray<UActorComponent*> PooledStaticMeshes;
+
+	UPROPERTY(Transient)
+	TArray<UActorComponent*> PooledSplineMeshes;
+};
+
+/**
+* Placement of one layer's meshes as saved with the actor
+*/
+USTRUCT()
+struct FFlexLayerConstructionCache
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FName LayerName;
+
+	/** Spline points whose mesh is rendered, ascending. Set bits of the layer's placement mask */
+	UPROPERTY()
+	TArray<int32> VisibleIndices;
+
+	/** Segment parameters of each visible point, only for spline mesh layers that are not baked */
+	UPROPERTY()
+	TArray<FFlexSplineMeshParams> SplineParams;
+
+	/** Relative transform of each visible point, only for static mesh layers */
+	UPROPERTY()
+	TArray<FTransform> Transforms;
+};
+
+/**
+* Result of a complete construction, saved with the actor. Used instead of placing all meshes again on load,
+* as long as the hash of all construction inputs still matches
+*/
+USTRUCT()
+struct FFlexConstructionCache
+{
+	GENERATED_BODY()
+
+	/** Hash of all inputs the cached placement was computed from, zero if nothing is cached */
+	UPROPERTY()
+	uint32 InputHash = 0;
+
+	/** One entry per layer, in layer map order */
+	UPROPERTY()
+	TArray<FFlexLayerConstructionCache> Layers;
+};